@@ -0,0 +1,460 @@
+// Headless benchmarks for the imnodes internals. The implementation is included directly, so that
+// the benchmarks can call the helpers in its anonymous namespace. Run a release build; each
+// benchmark prints the mean time of a run in milliseconds.
+
+#include "imnodes.cpp"
+
+#include <imgui.h>
+
+#include <stdio.h>
+
+namespace
+{
+using namespace IMNODES_NAMESPACE;
+
+// A benchmark is run until its runs have taken MinTotalTime milliseconds, and at least once.
+struct BenchmarkTimings
+{
+    enum
+    {
+        MinTotalTime = 500,
+        MaxRuns = 1000
+    };
+
+    float TotalTime;
+    int   Runs;
+
+    BenchmarkTimings() : TotalTime(0.f), Runs(0) {}
+
+    inline bool Done() const { return Runs >= MaxRuns || TotalTime >= float(MinTotalTime); }
+
+    inline void Add(const float time)
+    {
+        TotalTime += time;
+        ++Runs;
+    }
+
+    inline float Mean() const { return Runs > 0 ? TotalTime / float(Runs) : 0.f; }
+};
+
+// A xorshift generator, so that the benchmarks are the same on every platform
+struct Random
+{
+    ImU32 State;
+
+    Random() : State(0x9e3779b9u) {}
+
+    inline ImU32 Next()
+    {
+        State ^= State << 13;
+        State ^= State >> 17;
+        State ^= State << 5;
+        return State;
+    }
+
+    // Returns an integer in [0, count)
+    inline int NextInt(const int count) { return static_cast<int>(Next() % ImU32(count)); }
+};
+
+void Shuffle(Random& random, ImVector<int>& values)
+{
+    for (int i = values.Size - 1; i > 0; --i)
+    {
+        ImSwap(values[i], values[random.NextInt(i + 1)]);
+    }
+}
+
+void BeginBenchmarkFrame()
+{
+    ImGui::NewFrame();
+    ImGui::Begin("benchmark");
+}
+
+void EndBenchmarkFrame()
+{
+    ImGui::End();
+    ImGui::Render();
+}
+
+// [SECTION] depth sort
+
+// The depth sort used before the channels were permuted in linear time. For each depth, the node's
+// submission index is searched for linearly, and its channels are bubbled into place one swap at a
+// time.
+void LegacyDrawListSortChannelsByDepth(const ImNodeDepthOrder& depth_order)
+{
+    if (GImNodes->NodeIdxSubmissionOrder.Size < 2)
+    {
+        return;
+    }
+
+    static ImVector<int> node_idx_depth_order;
+    node_idx_depth_order.resize(0);
+    for (int node_idx = depth_order.Bottom; node_idx != -1; node_idx = depth_order.Next[node_idx])
+    {
+        if (DrawListIsNodeSubmitted(node_idx))
+        {
+            node_idx_depth_order.push_back(node_idx);
+        }
+    }
+
+    int start_idx = node_idx_depth_order.Size - 1;
+
+    while (node_idx_depth_order[start_idx] == GImNodes->NodeIdxSubmissionOrder[start_idx])
+    {
+        if (--start_idx == 0)
+        {
+            return;
+        }
+    }
+
+    for (int depth_idx = start_idx; depth_idx > 0; --depth_idx)
+    {
+        const int node_idx = node_idx_depth_order[depth_idx];
+
+        int submission_idx = -1;
+        for (int i = 0; i < GImNodes->NodeIdxSubmissionOrder.Size; ++i)
+        {
+            if (GImNodes->NodeIdxSubmissionOrder[i] == node_idx)
+            {
+                submission_idx = i;
+                break;
+            }
+        }
+        IM_ASSERT(submission_idx >= 0);
+
+        for (int j = submission_idx; j < depth_idx; ++j)
+        {
+            // Also swaps the nodes in NodeIdxSubmissionOrder
+            DrawListSwapSubmissionIndices(j, j + 1);
+        }
+    }
+}
+
+// Submits the nodes in index order, and puts them in a random depth order.
+void SetupDepthSort(Random& random, ImNodeDepthOrder& depth_order, const int node_count)
+{
+    DrawListSet(ImGui::GetWindowDrawList());
+    for (int node_idx = 0; node_idx < node_count; ++node_idx)
+    {
+        DrawListAddNode(node_idx);
+    }
+
+    ImVector<int> node_indices;
+    node_indices.resize(node_count);
+    for (int node_idx = 0; node_idx < node_count; ++node_idx)
+    {
+        node_indices[node_idx] = node_idx;
+    }
+    Shuffle(random, node_indices);
+
+    depth_order = ImNodeDepthOrder();
+    depth_order.Reserve(node_count);
+    for (int i = 0; i < node_count; ++i)
+    {
+        depth_order.PushTop(node_indices[i]);
+    }
+}
+
+bool SubmissionOrderMatchesDepthOrder(const ImNodeDepthOrder& depth_order)
+{
+    int submission_idx = 0;
+    for (int node_idx = depth_order.Bottom; node_idx != -1; node_idx = depth_order.Next[node_idx])
+    {
+        if (GImNodes->NodeIdxSubmissionOrder[submission_idx++] != node_idx)
+        {
+            return false;
+        }
+    }
+    return submission_idx == GImNodes->NodeIdxSubmissionOrder.Size;
+}
+
+bool BenchmarkDepthSort(const int node_count, const bool legacy)
+{
+    Random           random;
+    ImNodeDepthOrder depth_order;
+    BenchmarkTimings timings;
+
+    BeginBenchmarkFrame();
+    while (!timings.Done())
+    {
+        SetupDepthSort(random, depth_order, node_count);
+
+        const FrameTimer timer;
+        if (legacy)
+        {
+            LegacyDrawListSortChannelsByDepth(depth_order);
+        }
+        else
+        {
+            DrawListSortChannelsByDepth(depth_order);
+        }
+        timings.Add(timer.Elapsed());
+
+        const bool sorted = SubmissionOrderMatchesDepthOrder(depth_order);
+        ImGui::GetWindowDrawList()->ChannelsMerge();
+        if (!sorted)
+        {
+            EndBenchmarkFrame();
+            printf("depth sort: the nodes are not in depth order\n");
+            return false;
+        }
+    }
+    EndBenchmarkFrame();
+
+    printf(
+        "depth sort, %-7s %6d nodes: %10.3f ms (%d runs)\n",
+        legacy ? "legacy" : "current",
+        node_count,
+        timings.Mean(),
+        timings.Runs);
+    return true;
+}
+
+// [SECTION] id maps
+
+// The id map used by the object pools before ImIdMap, a sorted vector
+struct StorageIdMap
+{
+    ImGuiStorage Storage;
+
+    inline int GetIndex(const int id) const
+    {
+        return Storage.GetInt(static_cast<ImGuiID>(id), -1);
+    }
+
+    inline void SetIndex(const int id, const int index)
+    {
+        Storage.SetInt(static_cast<ImGuiID>(id), index);
+    }
+};
+
+// Creates an index for each id the way ObjectPoolFindOrCreateIndex() does, then looks up every id
+// once per frame, the way a frame submitting all the objects again does.
+template<typename IdMap>
+bool BenchmarkIdMap(
+    const char*          map_name,
+    const ImVector<int>& ids,
+    const ImVector<int>& lookup_order)
+{
+    BenchmarkTimings create_timings;
+    while (!create_timings.Done())
+    {
+        IdMap            id_map;
+        const FrameTimer timer;
+        for (int i = 0; i < ids.Size; ++i)
+        {
+            if (id_map.GetIndex(ids[i]) == -1)
+            {
+                id_map.SetIndex(ids[i], i);
+            }
+        }
+        create_timings.Add(timer.Elapsed());
+    }
+
+    IdMap id_map;
+    ImU32 expected_index_sum = 0;
+    for (int i = 0; i < ids.Size; ++i)
+    {
+        id_map.SetIndex(ids[i], i);
+        expected_index_sum += static_cast<ImU32>(i);
+    }
+
+    BenchmarkTimings frame_timings;
+    while (!frame_timings.Done())
+    {
+        const FrameTimer timer;
+        ImU32            index_sum = 0;
+        for (int i = 0; i < lookup_order.Size; ++i)
+        {
+            index_sum += static_cast<ImU32>(id_map.GetIndex(lookup_order[i]));
+        }
+        frame_timings.Add(timer.Elapsed());
+
+        if (index_sum != expected_index_sum)
+        {
+            printf("id map, %s: a lookup returned the wrong index\n", map_name);
+            return false;
+        }
+    }
+
+    printf(
+        "id map, %-7s %6d ids: create %10.3f ms, frame %10.3f ms\n",
+        map_name,
+        ids.Size,
+        create_timings.Mean(),
+        frame_timings.Mean());
+    return true;
+}
+
+bool BenchmarkIdMaps(const int id_count)
+{
+    // Multiplying by an odd constant maps distinct integers to distinct ids
+    Random        random;
+    ImVector<int> ids;
+    ids.resize(id_count);
+    for (int i = 0; i < id_count; ++i)
+    {
+        ids[i] = static_cast<int>(static_cast<ImU32>(i) * 2654435761u);
+    }
+    Shuffle(random, ids);
+
+    ImVector<int> lookup_order = ids;
+    Shuffle(random, lookup_order);
+
+    return BenchmarkIdMap<StorageIdMap>("storage", ids, lookup_order) &&
+           BenchmarkIdMap<ImIdMap>("ImIdMap", ids, lookup_order);
+}
+
+// [SECTION] editor frame
+
+// Submits a graph in which each node has two input and two output pins, and each node's first
+// output is linked to the next node's first input. The nodes are laid out on a grid, most of them
+// outside of the visible canvas.
+void SubmitGraph(const int node_count)
+{
+    for (int node_idx = 0; node_idx < node_count; ++node_idx)
+    {
+        ImNodes::BeginNode(node_idx);
+        for (int pin = 0; pin < 4; ++pin)
+        {
+            if (pin < 2)
+            {
+                ImNodes::BeginInputAttribute(4 * node_idx + pin);
+            }
+            else
+            {
+                ImNodes::BeginOutputAttribute(4 * node_idx + pin);
+            }
+            ImGui::Dummy(ImVec2(80.f, 16.f));
+            if (pin < 2)
+            {
+                ImNodes::EndInputAttribute();
+            }
+            else
+            {
+                ImNodes::EndOutputAttribute();
+            }
+        }
+        ImNodes::EndNode();
+    }
+
+    for (int node_idx = 0; node_idx < node_count; ++node_idx)
+    {
+        ImNodes::Link(node_idx, 4 * node_idx + 2, 4 * ((node_idx + 1) % node_count));
+    }
+}
+
+bool BenchmarkEditorFrame(const int node_count)
+{
+    {
+        const int        columns = 256;
+        ImVector<int>    node_ids;
+        ImVector<ImVec2> positions;
+        node_ids.resize(node_count);
+        positions.resize(node_count);
+        for (int node_idx = 0; node_idx < node_count; ++node_idx)
+        {
+            node_ids[node_idx] = node_idx;
+            positions[node_idx] =
+                ImVec2(160.f * float(node_idx % columns), 120.f * float(node_idx / columns));
+        }
+        ImNodes::SetNodeGridSpacePositions(node_ids.Data, positions.Data, node_count);
+    }
+
+    // The first frames create the pins and links, and grow the editor's buffers
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        BeginBenchmarkFrame();
+        ImNodes::BeginNodeEditor();
+        SubmitGraph(node_count);
+        ImNodes::EndNodeEditor();
+        EndBenchmarkFrame();
+    }
+
+    BenchmarkTimings  timings;
+    ImNodesFrameStats stats;
+    while (!timings.Done())
+    {
+        BeginBenchmarkFrame();
+        const FrameTimer timer;
+        ImNodes::BeginNodeEditor();
+        SubmitGraph(node_count);
+        ImNodes::EndNodeEditor();
+        timings.Add(timer.Elapsed());
+        ImNodes::GetFrameStats(&stats);
+        EndBenchmarkFrame();
+    }
+
+    if (stats.PinsSubmitted != 4 * node_count || stats.LinksSubmitted != node_count)
+    {
+        printf("editor frame: the graph wasn't submitted\n");
+        return false;
+    }
+
+    printf(
+        "editor frame, %6d nodes, %6d pins, %6d links: %10.3f ms (%d runs)\n",
+        stats.NodesSubmitted,
+        stats.PinsSubmitted,
+        stats.LinksSubmitted,
+        timings.Mean(),
+        timings.Runs);
+    printf(
+        "  last frame: hover %.3f ms, draw %.3f ms, depth sort %.3f ms, channels merge %.3f ms\n",
+        stats.HoverResolutionTime,
+        stats.DrawTime,
+        stats.DepthSortTime,
+        stats.ChannelsMergeTime);
+    printf(
+        "  hot/cold bytes: node %d/%d, pin %d/%d, link %d/%d\n",
+        int(sizeof(ImNodeData)),
+        int(sizeof(ImNodeColdData)),
+        int(sizeof(ImPinData)),
+        int(sizeof(ImPinColdData)),
+        int(sizeof(ImLinkData)),
+        int(sizeof(ImLinkColdData)));
+    return true;
+}
+} // namespace
+
+int main(int, char**)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1920.f, 1080.f);
+    io.DeltaTime = 1.f / 60.f;
+    io.IniFilename = NULL;
+#if IMGUI_VERSION_NUM < 19200
+    unsigned char* pixels = NULL;
+    int            width = 0, height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+#else
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+#endif
+    ImNodes::CreateContext();
+
+    bool ok = true;
+
+    const int depth_sort_node_counts[] = {1000, 10000, 50000};
+    for (int i = 0; i < IM_ARRAYSIZE(depth_sort_node_counts) && ok; ++i)
+    {
+        ok = BenchmarkDepthSort(depth_sort_node_counts[i], true) &&
+             BenchmarkDepthSort(depth_sort_node_counts[i], false);
+    }
+
+    const int id_map_id_counts[] = {10000, 50000, 200000};
+    for (int i = 0; i < IM_ARRAYSIZE(id_map_id_counts) && ok; ++i)
+    {
+        ok = BenchmarkIdMaps(id_map_id_counts[i]);
+    }
+
+    // 25k nodes with 100k pins, the size the hot and cold object data split was measured with
+    if (ok)
+    {
+        ok = BenchmarkEditorFrame(25000);
+    }
+
+    ImNodes::DestroyContext();
+    ImGui::DestroyContext();
+    return ok ? 0 : 1;
+}
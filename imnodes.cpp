@@ -1,6 +1,8 @@
 // the structure of this file:
 //
 // [SECTION] bezier curve helpers
+// [SECTION] spatial grid helpers
+// [SECTION] link bvh helpers
 // [SECTION] draw list helper
 // [SECTION] ui state logic
 // [SECTION] render helpers
@@ -14,6 +16,7 @@
 #error "Minimum ImGui version requirement not met -- please use a newer version!"
 #endif
 
+#include <chrono>
 #include <limits.h>
 #include <math.h>
 #include <new>
@@ -60,51 +63,56 @@ inline ImVec2 EvalCubicBezier(
         b0 * P0.y + b1 * P1.y + b2 * P2.y + b3 * P3.y);
 }
 
-// Calculates the closest point along each bezier curve segment.
-ImVec2 GetClosestPointOnCubicBezier(const int num_segments, const ImVec2& p, const CubicBezier& cb)
+// Flattens the curve into line segments at the same parameter values which ImDrawList uses when it
+// is given a segment count, so that drawing the polyline matches drawing the curve.
+inline void EvalCubicBezierPolyline(const CubicBezier& cb, ImVector<ImVec2>& points)
 {
-    IM_ASSERT(num_segments > 0);
-    ImVec2 p_last = cb.P0;
+    IM_ASSERT(cb.NumSegments > 0);
+    points.resize(cb.NumSegments + 1);
+    points[0] = cb.P0;
+    const float t_step = 1.0f / (float)cb.NumSegments;
+    for (int i = 1; i <= cb.NumSegments; ++i)
+    {
+        points[i] = EvalCubicBezier(t_step * i, cb.P0, cb.P1, cb.P2, cb.P3);
+    }
+}
+
+// Calculates the closest point along each polyline segment.
+ImVec2 GetClosestPointOnPolyline(const ImVector<ImVec2>& points, const ImVec2& p)
+{
+    IM_ASSERT(points.size() > 1);
     ImVec2 p_closest;
     float  p_closest_dist = FLT_MAX;
-    float  t_step = 1.0f / (float)num_segments;
-    for (int i = 1; i <= num_segments; ++i)
+    for (int i = 1; i < points.size(); ++i)
     {
-        ImVec2 p_current = EvalCubicBezier(t_step * i, cb.P0, cb.P1, cb.P2, cb.P3);
-        ImVec2 p_line = ImLineClosestPoint(p_last, p_current, p);
+        ImVec2 p_line = ImLineClosestPoint(points[i - 1], points[i], p);
         float  dist = ImLengthSqr(p - p_line);
         if (dist < p_closest_dist)
         {
             p_closest = p_line;
             p_closest_dist = dist;
         }
-        p_last = p_current;
     }
     return p_closest;
 }
 
-inline float GetDistanceToCubicBezier(
-    const ImVec2&      pos,
-    const CubicBezier& cubic_bezier,
-    const int          num_segments)
+inline float GetDistanceToPolyline(const ImVec2& pos, const ImVector<ImVec2>& points)
 {
-    const ImVec2 point_on_curve = GetClosestPointOnCubicBezier(num_segments, pos, cubic_bezier);
+    const ImVec2 point_on_curve = GetClosestPointOnPolyline(points, pos);
 
     const ImVec2 to_curve = point_on_curve - pos;
     return ImSqrt(ImLengthSqr(to_curve));
 }
 
-inline ImRect GetContainingRectForCubicBezier(const CubicBezier& cb)
+// The curve is contained within the convex hull of its control points
+inline ImRect GetControlPointRectForCubicBezier(const CubicBezier& cb)
 {
     const ImVec2 min = ImVec2(ImMin(cb.P0.x, cb.P3.x), ImMin(cb.P0.y, cb.P3.y));
     const ImVec2 max = ImVec2(ImMax(cb.P0.x, cb.P3.x), ImMax(cb.P0.y, cb.P3.y));
 
-    const float hover_distance = GImNodes->Style.LinkHoverDistance;
-
     ImRect rect(min, max);
     rect.Add(cb.P1);
     rect.Add(cb.P2);
-    rect.Expand(ImVec2(hover_distance, hover_distance));
 
     return rect;
 }
@@ -189,34 +197,24 @@ inline bool RectangleOverlapsLineSegment(const ImRect& rect, const ImVec2& p1, c
     return abs(sum) != sum_abs;
 }
 
-inline bool RectangleOverlapsBezier(const ImRect& rectangle, const CubicBezier& cubic_bezier)
+inline bool RectangleOverlapsPolyline(const ImRect& rectangle, const ImVector<ImVec2>& points)
 {
-    ImVec2 current =
-        EvalCubicBezier(0.f, cubic_bezier.P0, cubic_bezier.P1, cubic_bezier.P2, cubic_bezier.P3);
-    const float dt = 1.0f / cubic_bezier.NumSegments;
-    for (int s = 0; s < cubic_bezier.NumSegments; ++s)
+    for (int i = 1; i < points.size(); ++i)
     {
-        ImVec2 next = EvalCubicBezier(
-            static_cast<float>((s + 1) * dt),
-            cubic_bezier.P0,
-            cubic_bezier.P1,
-            cubic_bezier.P2,
-            cubic_bezier.P3);
-        if (RectangleOverlapsLineSegment(rectangle, current, next))
+        if (RectangleOverlapsLineSegment(rectangle, points[i - 1], points[i]))
         {
             return true;
         }
-        current = next;
     }
     return false;
 }
 
-inline bool RectangleOverlapsLink(
-    const ImRect&              rectangle,
-    const ImVec2&              start,
-    const ImVec2&              end,
-    const ImNodesAttributeType start_type)
+// Both the rectangle and the link's cached geometry are in grid space.
+inline bool RectangleOverlapsLink(const ImRect& rectangle, const ImLinkData& link)
 {
+    const ImVec2& start = link.GridSpaceStartPos;
+    const ImVec2& end = link.GridSpaceEndPos;
+
     // First level: simple rejection test via rectangle overlap:
 
     ImRect lrect = ImRect(start, end);
@@ -243,9 +241,7 @@ inline bool RectangleOverlapsLink(
         // Second level of refinement: do a more expensive test against the
         // link
 
-        const CubicBezier cubic_bezier =
-            GetCubicBezier(start, end, start_type, GImNodes->Style.LinkLineSegmentsPerLength);
-        return RectangleOverlapsBezier(rectangle, cubic_bezier);
+        return RectangleOverlapsPolyline(rectangle, link.GridSpacePolyline);
     }
 
     return false;
@@ -268,6 +264,11 @@ inline ImVec2 GridSpaceToScreenSpace(const ImNodesEditorContext& editor, const I
     return v + GImNodes->CanvasOriginScreenSpace + editor.Panning;
 }
 
+inline ImRect GridSpaceToScreenSpace(const ImNodesEditorContext& editor, const ImRect& r)
+{
+    return ImRect(GridSpaceToScreenSpace(editor, r.Min), GridSpaceToScreenSpace(editor, r.Max));
+}
+
 inline ImVec2 GridSpaceToEditorSpace(const ImNodesEditorContext& editor, const ImVec2& v)
 {
     return v + editor.Panning;
@@ -296,12 +297,492 @@ inline ImVec2 ScreenSpaceToMiniMapSpace(const ImNodesEditorContext& editor, cons
            editor.MiniMapContentScreenSpace.Min;
 }
 
+inline ImVec2 GridSpaceToMiniMapSpace(const ImNodesEditorContext& editor, const ImVec2& v)
+{
+    return (v - editor.GridContentBounds.Min) * editor.MiniMapScaling +
+           editor.MiniMapContentScreenSpace.Min;
+}
+
 inline ImRect ScreenSpaceToMiniMapSpace(const ImNodesEditorContext& editor, const ImRect& r)
 {
     return ImRect(
         ScreenSpaceToMiniMapSpace(editor, r.Min), ScreenSpaceToMiniMapSpace(editor, r.Max));
 }
 
+// [SECTION] spatial grid helpers
+
+inline int SpatialGridCellCoordinate(const ImSpatialGrid& grid, const float v)
+{
+    return static_cast<int>(floorf(v / grid.CellSize));
+}
+
+inline int SpatialGridCellKey(const int x, const int y)
+{
+    return static_cast<int>(static_cast<ImU32>(x) * 73856093u ^ static_cast<ImU32>(y) * 19349663u);
+}
+
+ImSpatialGrid::CellRange SpatialGridGetCellRange(const ImSpatialGrid& grid, const ImRect& rect)
+{
+    ImSpatialGrid::CellRange range;
+    range.MinX = SpatialGridCellCoordinate(grid, rect.Min.x);
+    range.MinY = SpatialGridCellCoordinate(grid, rect.Min.y);
+    range.MaxX = SpatialGridCellCoordinate(grid, rect.Max.x);
+    range.MaxY = SpatialGridCellCoordinate(grid, rect.Max.y);
+    return range;
+}
+
+void SpatialGridInsert(
+    ImSpatialGrid&                  grid,
+    const int                       node_idx,
+    const ImSpatialGrid::CellRange& range)
+{
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+    {
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+        {
+            int entry_idx = grid.FreeEntryHead;
+            if (entry_idx == -1)
+            {
+                entry_idx = grid.Entries.size();
+                grid.Entries.resize(entry_idx + 1);
+            }
+            else
+            {
+                grid.FreeEntryHead = grid.Entries[entry_idx].Next;
+            }
+
+            const int cell_key = SpatialGridCellKey(x, y);
+            grid.Entries[entry_idx].NodeIdx = node_idx;
+            grid.Entries[entry_idx].Next = grid.CellHeads.GetIndex(cell_key);
+            grid.CellHeads.SetIndex(cell_key, entry_idx);
+        }
+    }
+}
+
+void SpatialGridRemove(
+    ImSpatialGrid&                  grid,
+    const int                       node_idx,
+    const ImSpatialGrid::CellRange& range)
+{
+    for (int y = range.MinY; y <= range.MaxY; ++y)
+    {
+        for (int x = range.MinX; x <= range.MaxX; ++x)
+        {
+            const int cell_key = SpatialGridCellKey(x, y);
+            int       prev_entry_idx = -1;
+            int       entry_idx = grid.CellHeads.GetIndex(cell_key);
+            while (entry_idx != -1 && grid.Entries[entry_idx].NodeIdx != node_idx)
+            {
+                prev_entry_idx = entry_idx;
+                entry_idx = grid.Entries[entry_idx].Next;
+            }
+            IM_ASSERT(entry_idx != -1);
+
+            const int next_entry_idx = grid.Entries[entry_idx].Next;
+            if (prev_entry_idx != -1)
+            {
+                grid.Entries[prev_entry_idx].Next = next_entry_idx;
+            }
+            else if (next_entry_idx != -1)
+            {
+                grid.CellHeads.SetIndex(cell_key, next_entry_idx);
+            }
+            else
+            {
+                // Empty cells are removed, so that the cells a node has passed through while being
+                // dragged don't accumulate in the map
+                grid.CellHeads.Remove(cell_key);
+            }
+            grid.Entries[entry_idx].Next = grid.FreeEntryHead;
+            grid.FreeEntryHead = entry_idx;
+        }
+    }
+}
+
+// Moves the node to the given cells. Nodes which haven't moved to another cell are left untouched,
+// so updating the grid for static nodes is cheap.
+void SpatialGridUpdateNode(
+    ImSpatialGrid&                  grid,
+    const int                       node_idx,
+    const ImSpatialGrid::CellRange& range)
+{
+    if (grid.NodeCellRanges.size() <= node_idx)
+    {
+        grid.NodeCellRanges.resize(node_idx + 1, ImSpatialGrid::CellRange());
+    }
+
+    ImSpatialGrid::CellRange& node_range = grid.NodeCellRanges[node_idx];
+    if (node_range == range)
+    {
+        return;
+    }
+
+    SpatialGridRemove(grid, node_idx, node_range);
+    SpatialGridInsert(grid, node_idx, range);
+    node_range = range;
+}
+
+// Returns the index of the first entry in the cell containing the grid space position, or -1 if
+// the cell is empty. The rest of the entries are found by following ImSpatialGrid::Entry::Next.
+int SpatialGridFindCell(const ImSpatialGrid& grid, const ImVec2& pos)
+{
+    return grid.CellHeads.GetIndex(SpatialGridCellKey(
+        SpatialGridCellCoordinate(grid, pos.x), SpatialGridCellCoordinate(grid, pos.y)));
+}
+
+// [SECTION] link bvh helpers
+
+const int LinkBvhMaxLeafSize = 4;
+
+void LinkBvhBuildNode(
+    ImLinkBvh&                      bvh,
+    const ImObjectPool<ImLinkData>& links,
+    const int                       link_start,
+    const int                       link_count)
+{
+    const int bvh_node_idx = bvh.Nodes.size();
+    bvh.Nodes.resize(bvh_node_idx + 1);
+
+    ImRect bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    ImRect centroid_bounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = link_start; i < link_start + link_count; ++i)
+    {
+        const ImRect& link_bounds = links.Pool[bvh.LinkIndices[i]].GridSpaceBounds;
+        bounds.Add(link_bounds);
+        centroid_bounds.Add(link_bounds.GetCenter());
+    }
+
+    int num_left = 0;
+    if (link_count > LinkBvhMaxLeafSize)
+    {
+        // Split the links at the middle of the longest axis of their centroids
+        const ImVec2 centroid_size = centroid_bounds.GetSize();
+        const int    axis = centroid_size.x >= centroid_size.y ? 0 : 1;
+        const float  split =
+            axis == 0 ? centroid_bounds.GetCenter().x : centroid_bounds.GetCenter().y;
+
+        for (int i = link_start; i < link_start + link_count; ++i)
+        {
+            const ImVec2 centroid = links.Pool[bvh.LinkIndices[i]].GridSpaceBounds.GetCenter();
+            if ((axis == 0 ? centroid.x : centroid.y) < split)
+            {
+                ImSwap(bvh.LinkIndices[i], bvh.LinkIndices[link_start + num_left]);
+                ++num_left;
+            }
+        }
+
+        // All centroids are on the same side of the split, e.g. when the links overlap. Split the
+        // links in half instead, to keep the tree balanced.
+        if (num_left == 0 || num_left == link_count)
+        {
+            num_left = link_count / 2;
+        }
+    }
+
+    if (num_left == 0)
+    {
+        ImLinkBvh::Node& leaf = bvh.Nodes[bvh_node_idx];
+        leaf.Bounds = bounds;
+        leaf.LinkStart = link_start;
+        leaf.LinkCount = link_count;
+    }
+    else
+    {
+        LinkBvhBuildNode(bvh, links, link_start, num_left);
+        LinkBvhBuildNode(bvh, links, link_start + num_left, link_count - num_left);
+
+        ImLinkBvh::Node& node = bvh.Nodes[bvh_node_idx];
+        node.Bounds = bounds;
+        node.LinkStart = link_start;
+        node.LinkCount = 0;
+    }
+
+    bvh.Nodes[bvh_node_idx].SkipIdx = bvh.Nodes.size();
+}
+
+void LinkBvhBuild(ImLinkBvh& bvh, const ImObjectPool<ImLinkData>& links)
+{
+    bvh.Nodes.resize(0);
+    bvh.LinkIndices.resize(0);
+
+    for (int link_idx = 0; link_idx < links.Pool.size(); ++link_idx)
+    {
+        if (links.InUse[link_idx])
+        {
+            bvh.LinkIndices.push_back(link_idx);
+        }
+    }
+
+    if (!bvh.LinkIndices.empty())
+    {
+        LinkBvhBuildNode(bvh, links, 0, bvh.LinkIndices.size());
+    }
+}
+
+// Updates the bounds of the tree nodes after links have moved, without changing the tree structure.
+void LinkBvhRefit(ImLinkBvh& bvh, const ImObjectPool<ImLinkData>& links)
+{
+    // Children are stored after their parents, so iterating backwards visits the children first
+    for (int bvh_node_idx = bvh.Nodes.size() - 1; bvh_node_idx >= 0; --bvh_node_idx)
+    {
+        ImLinkBvh::Node& node = bvh.Nodes[bvh_node_idx];
+        if (node.LinkCount > 0)
+        {
+            node.Bounds = links.Pool[bvh.LinkIndices[node.LinkStart]].GridSpaceBounds;
+            for (int i = node.LinkStart + 1; i < node.LinkStart + node.LinkCount; ++i)
+            {
+                node.Bounds.Add(links.Pool[bvh.LinkIndices[i]].GridSpaceBounds);
+            }
+        }
+        else
+        {
+            const ImLinkBvh::Node& left_child = bvh.Nodes[bvh_node_idx + 1];
+            node.Bounds = left_child.Bounds;
+            node.Bounds.Add(bvh.Nodes[left_child.SkipIdx].Bounds);
+        }
+    }
+}
+
+int CompareInts(const void* lhs, const void* rhs)
+{
+    const int lhs_value = *static_cast<const int*>(lhs);
+    const int rhs_value = *static_cast<const int*>(rhs);
+    return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+}
+
+// Finds the in-use links whose bounds overlap the grid space rectangle. The link indices are
+// returned in ascending order.
+void LinkBvhQuery(
+    const ImLinkBvh&                bvh,
+    const ImObjectPool<ImLinkData>& links,
+    const ImRect&                   rect,
+    ImVector<int>&                  link_indices)
+{
+    link_indices.resize(0);
+
+    int bvh_node_idx = 0;
+    while (bvh_node_idx < bvh.Nodes.size())
+    {
+        const ImLinkBvh::Node& node = bvh.Nodes[bvh_node_idx];
+        if (!rect.Overlaps(node.Bounds))
+        {
+            bvh_node_idx = node.SkipIdx;
+            continue;
+        }
+
+        for (int i = node.LinkStart; i < node.LinkStart + node.LinkCount; ++i)
+        {
+            const int link_idx = bvh.LinkIndices[i];
+            if (links.InUse[link_idx] && rect.Overlaps(links.Pool[link_idx].GridSpaceBounds))
+            {
+                link_indices.push_back(link_idx);
+            }
+        }
+
+        ++bvh_node_idx;
+    }
+
+    if (link_indices.size() > 1)
+    {
+        qsort(link_indices.Data, link_indices.size(), sizeof(int), CompareInts);
+    }
+}
+
+// [SECTION] pin link index
+
+void PinLinkIndexBuild(
+    ImPinLinkIndex&                 index,
+    const ImObjectPool<ImLinkData>& links,
+    const int                       num_pins)
+{
+    // Count the links of each pin, offset by one so that the prefix sum yields the start offsets
+    index.Offsets.resize(num_pins + 1);
+    memset(index.Offsets.Data, 0, sizeof(int) * index.Offsets.size());
+    for (int link_idx = 0; link_idx < links.Pool.size(); ++link_idx)
+    {
+        const ImLinkData& link = links.Pool[link_idx];
+        if (links.IdMap.GetIndex(link.Id) != link_idx)
+        {
+            continue;
+        }
+
+        ++index.Offsets[link.StartPinIdx + 1];
+        if (link.EndPinIdx != link.StartPinIdx)
+        {
+            ++index.Offsets[link.EndPinIdx + 1];
+        }
+    }
+
+    for (int pin_idx = 0; pin_idx < num_pins; ++pin_idx)
+    {
+        index.Offsets[pin_idx + 1] += index.Offsets[pin_idx];
+    }
+
+    // Each pin's offset is advanced past its links as they are written, and shifted back to the
+    // start of the range afterwards. Each pin's links are therefore in increasing link index order,
+    // so that the link checks walking them pick the same link as a scan over the pool would. This
+    // order isn't part of the public API, as link indices aren't exposed.
+    index.LinkIndices.resize(index.Offsets[num_pins]);
+    for (int link_idx = 0; link_idx < links.Pool.size(); ++link_idx)
+    {
+        const ImLinkData& link = links.Pool[link_idx];
+        if (links.IdMap.GetIndex(link.Id) != link_idx)
+        {
+            continue;
+        }
+
+        index.LinkIndices[index.Offsets[link.StartPinIdx]++] = link_idx;
+        if (link.EndPinIdx != link.StartPinIdx)
+        {
+            index.LinkIndices[index.Offsets[link.EndPinIdx]++] = link_idx;
+        }
+    }
+
+    for (int pin_idx = num_pins; pin_idx > 0; --pin_idx)
+    {
+        index.Offsets[pin_idx] = index.Offsets[pin_idx - 1];
+    }
+    index.Offsets[0] = 0;
+}
+
+void PinLinkIndexUpdate(ImNodesEditorContext& editor)
+{
+    if (editor.PinLinks.Dirty)
+    {
+        PinLinkIndexBuild(editor.PinLinks, editor.Links, editor.Pins.Pool.size());
+        editor.PinLinks.Dirty = false;
+    }
+}
+
+// Returns the number of links connected to the pin, and the offset of the first one in
+// ImPinLinkIndex::LinkIndices
+inline int PinLinkIndexGetLinks(const ImPinLinkIndex& index, const int pin_idx, int* first)
+{
+    IM_ASSERT(!index.Dirty);
+    if (pin_idx + 1 >= index.Offsets.size())
+    {
+        *first = 0;
+        return 0;
+    }
+
+    *first = index.Offsets[pin_idx];
+    return index.Offsets[pin_idx + 1] - index.Offsets[pin_idx];
+}
+
+// [SECTION] allocation counter
+
+// Marks the allocations made until the end of the enclosing scope as made by imnodes. The scopes are
+// opened by the API functions doing per-frame work, so that the allocations made by the UI code
+// between them aren't counted.
+struct AllocationCounterScope
+{
+    AllocationCounterScope() { ++GImNodes->AllocationScopeDepth; }
+    ~AllocationCounterScope() { --GImNodes->AllocationScopeDepth; }
+};
+
+#if IMGUI_VERSION_NUM >= 18300
+// The allocator functions of ImGui are process-wide, so the counting allocator functions are
+// installed once, while any context has the counter enabled, and count the allocations for the
+// current context.
+struct AllocationCounterHook
+{
+    bool              Installed;
+    int               EnabledContextCount;
+    ImGuiMemAllocFunc ChainedMemAllocFunc;
+    ImGuiMemFreeFunc  ChainedMemFreeFunc;
+    void*             ChainedAllocatorUserData;
+};
+
+AllocationCounterHook GAllocationCounterHook;
+
+void* CountingMemAlloc(const size_t size, void* const user_data)
+{
+    (void)user_data;
+    if (GImNodes != NULL && GImNodes->AllocationCounterEnabled &&
+        GImNodes->AllocationScopeDepth > 0)
+    {
+        ++GImNodes->FrameAllocationCount;
+    }
+    return GAllocationCounterHook.ChainedMemAllocFunc(
+        size, GAllocationCounterHook.ChainedAllocatorUserData);
+}
+
+void CountingMemFree(void* const ptr, void* const user_data)
+{
+    (void)user_data;
+    GAllocationCounterHook.ChainedMemFreeFunc(ptr, GAllocationCounterHook.ChainedAllocatorUserData);
+}
+#endif
+
+void AllocationCounterSetEnabled(ImNodesContext& ctx, const bool enabled)
+{
+    if (ctx.AllocationCounterEnabled == enabled)
+    {
+        return;
+    }
+
+#if IMGUI_VERSION_NUM >= 18300
+    AllocationCounterHook& hook = GAllocationCounterHook;
+    if (enabled)
+    {
+        if (!hook.Installed)
+        {
+            ImGui::GetAllocatorFunctions(
+                &hook.ChainedMemAllocFunc,
+                &hook.ChainedMemFreeFunc,
+                &hook.ChainedAllocatorUserData);
+            ImGui::SetAllocatorFunctions(CountingMemAlloc, CountingMemFree, NULL);
+            hook.Installed = true;
+        }
+        ++hook.EnabledContextCount;
+    }
+    else
+    {
+        IM_ASSERT(hook.EnabledContextCount > 0);
+        if (--hook.EnabledContextCount == 0)
+        {
+            ImGuiMemAllocFunc alloc_func;
+            ImGuiMemFreeFunc  free_func;
+            void*             user_data;
+            ImGui::GetAllocatorFunctions(&alloc_func, &free_func, &user_data);
+            // If the allocator functions were replaced after the counter was enabled, the
+            // replacement may still forward to the counting functions, so they stay installed
+            // and keep forwarding to the chained functions.
+            if (alloc_func == CountingMemAlloc && free_func == CountingMemFree)
+            {
+                ImGui::SetAllocatorFunctions(
+                    hook.ChainedMemAllocFunc,
+                    hook.ChainedMemFreeFunc,
+                    hook.ChainedAllocatorUserData);
+                hook.Installed = false;
+            }
+        }
+    }
+    ctx.AllocationCounterEnabled = enabled;
+#else
+    // ImGui::GetAllocatorFunctions(), which is needed to chain the allocator functions, was added
+    // in Dear ImGui 1.83
+    IM_ASSERT(!"The allocation counter requires Dear ImGui 1.83 or newer!");
+#endif
+}
+
+// [SECTION] frame timer
+
+// Measures the time spent in a phase of EndNodeEditor() for ImNodesFrameStats.
+struct FrameTimer
+{
+    std::chrono::steady_clock::time_point Start;
+
+    FrameTimer() : Start(std::chrono::steady_clock::now()) {}
+
+    // Returns the milliseconds elapsed since the timer was created
+    float Elapsed() const
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - Start)
+            .count();
+    }
+};
+
 // [SECTION] draw list helper
 
 void ImDrawListGrowChannels(ImDrawList* draw_list, const int num_channels)
@@ -393,8 +874,21 @@ void ImDrawListSplitterSwapChannels(
 void DrawListSet(ImDrawList* window_draw_list)
 {
     GImNodes->CanvasDrawList = window_draw_list;
-    GImNodes->NodeIdxToSubmissionIdx.Clear();
-    GImNodes->NodeIdxSubmissionOrder.clear();
+    // The scratch buffers keep their memory from frame to frame. Filling the bytes with 0xff sets
+    // every submission index to -1.
+    ImVector<int>& node_idx_to_submission_idx = GImNodes->NodeIdxToSubmissionIdx;
+    if (!node_idx_to_submission_idx.empty())
+    {
+        memset(
+            node_idx_to_submission_idx.Data,
+            0xff,
+            sizeof(int) * node_idx_to_submission_idx.size());
+    }
+    GImNodes->NodeIdxSubmissionOrder.resize(0);
+    GImNodes->SingleNodeDrawChannel =
+        (GImNodes->Style.Flags & ImNodesStyleFlags_SingleNodeDrawChannel) != 0;
+    GImNodes->NodeDrawRanges.resize(0);
+    GImNodes->CurrentNodeDrawRangeIdx = -1;
 }
 
 // The draw list channels are structured as follows. First we have our base channel, the canvas grid
@@ -415,13 +909,46 @@ void DrawListSet(ImDrawList* window_draw_list)
 //            |   submission idx    |
 //            |                     |
 //            -----------------------
+//
+// With ImNodesStyleFlags_SingleNodeDrawChannel, all nodes share the channel after the canvas
+// channel instead. The node backgrounds and foregrounds are then recorded as ranges of that
+// channel's index buffer, which are sorted by depth in place of the channels.
 
 void DrawListAddNode(const int node_idx)
 {
-    GImNodes->NodeIdxToSubmissionIdx.SetInt(
-        static_cast<ImGuiID>(node_idx), GImNodes->NodeIdxSubmissionOrder.Size);
+    ImVector<int>& node_idx_to_submission_idx = GImNodes->NodeIdxToSubmissionIdx;
+    if (node_idx >= node_idx_to_submission_idx.Size)
+    {
+        node_idx_to_submission_idx.resize(node_idx + 1, -1);
+    }
+    node_idx_to_submission_idx[node_idx] = GImNodes->NodeIdxSubmissionOrder.Size;
     GImNodes->NodeIdxSubmissionOrder.push_back(node_idx);
-    ImDrawListGrowChannels(GImNodes->CanvasDrawList, 2);
+
+    if (GImNodes->SingleNodeDrawChannel)
+    {
+        // The first node creates the channel shared by all nodes
+        if (GImNodes->NodeIdxSubmissionOrder.Size == 1)
+        {
+            ImDrawListGrowChannels(GImNodes->CanvasDrawList, 1);
+        }
+        GImNodes->NodeDrawRanges.resize(GImNodes->NodeDrawRanges.Size + 2, ImNodeDrawRange());
+    }
+    else
+    {
+        ImDrawListGrowChannels(GImNodes->CanvasDrawList, 2);
+    }
+}
+
+// Returns -1 if the node hasn't been submitted during the current frame.
+inline int DrawListGetNodeSubmissionIdx(const int node_idx)
+{
+    const ImVector<int>& node_idx_to_submission_idx = GImNodes->NodeIdxToSubmissionIdx;
+    return node_idx < node_idx_to_submission_idx.Size ? node_idx_to_submission_idx[node_idx] : -1;
+}
+
+bool DrawListIsNodeSubmitted(const int node_idx)
+{
+    return DrawListGetNodeSubmissionIdx(node_idx) != -1;
 }
 
 void DrawListAppendClickInteractionChannel()
@@ -434,12 +961,32 @@ void DrawListAppendClickInteractionChannel()
 int DrawListSubmissionIdxToBackgroundChannelIdx(const int submission_idx)
 {
     // NOTE: the first channel is the canvas background, i.e. the grid
-    return 1 + 2 * submission_idx;
+    return GImNodes->SingleNodeDrawChannel ? 1 : 1 + 2 * submission_idx;
 }
 
 int DrawListSubmissionIdxToForegroundChannelIdx(const int submission_idx)
 {
-    return DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx) + 1;
+    return GImNodes->SingleNodeDrawChannel
+               ? 1
+               : DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx) + 1;
+}
+
+// Ends the node draw range currently being recorded, and starts recording the given range from the
+// current end of the shared node channel.
+void DrawListBeginNodeDrawRange(const int range_idx)
+{
+    IM_ASSERT(GImNodes->CanvasDrawList->_Splitter._Current == 1);
+    const int idx_count = GImNodes->CanvasDrawList->IdxBuffer.Size;
+
+    if (GImNodes->CurrentNodeDrawRangeIdx != -1)
+    {
+        GImNodes->NodeDrawRanges[GImNodes->CurrentNodeDrawRangeIdx].IdxEnd = idx_count;
+    }
+
+    ImNodeDrawRange& range = GImNodes->NodeDrawRanges[range_idx];
+    range.IdxBegin = idx_count;
+    range.IdxEnd = idx_count;
+    GImNodes->CurrentNodeDrawRangeIdx = range_idx;
 }
 
 void DrawListActivateClickInteractionChannel()
@@ -450,16 +997,20 @@ void DrawListActivateClickInteractionChannel()
 
 void DrawListActivateCurrentNodeForeground()
 {
-    const int foreground_channel_idx =
-        DrawListSubmissionIdxToForegroundChannelIdx(GImNodes->NodeIdxSubmissionOrder.Size - 1);
+    const int submission_idx = GImNodes->NodeIdxSubmissionOrder.Size - 1;
+    const int foreground_channel_idx = DrawListSubmissionIdxToForegroundChannelIdx(submission_idx);
     GImNodes->CanvasDrawList->_Splitter.SetCurrentChannel(
         GImNodes->CanvasDrawList, foreground_channel_idx);
+
+    if (GImNodes->SingleNodeDrawChannel)
+    {
+        DrawListBeginNodeDrawRange(2 * submission_idx + 1);
+    }
 }
 
 void DrawListActivateNodeBackground(const int node_idx)
 {
-    const int submission_idx =
-        GImNodes->NodeIdxToSubmissionIdx.GetInt(static_cast<ImGuiID>(node_idx), -1);
+    const int submission_idx = DrawListGetNodeSubmissionIdx(node_idx);
     // There is a discrepancy in the submitted node count and the rendered node count! Did you call
     // one of the following functions
     // * EditorContextMoveToNode
@@ -471,6 +1022,11 @@ void DrawListActivateNodeBackground(const int node_idx)
     const int background_channel_idx = DrawListSubmissionIdxToBackgroundChannelIdx(submission_idx);
     GImNodes->CanvasDrawList->_Splitter.SetCurrentChannel(
         GImNodes->CanvasDrawList, background_channel_idx);
+
+    if (GImNodes->SingleNodeDrawChannel)
+    {
+        DrawListBeginNodeDrawRange(2 * submission_idx);
+    }
 }
 
 void DrawListSwapSubmissionIndices(const int lhs_idx, const int rhs_idx)
@@ -490,78 +1046,341 @@ void DrawListSwapSubmissionIndices(const int lhs_idx, const int rhs_idx)
         GImNodes->CanvasDrawList->_Splitter,
         lhs_foreground_channel_idx,
         rhs_foreground_channel_idx);
+    ImSwap(GImNodes->NodeIdxSubmissionOrder[lhs_idx], GImNodes->NodeIdxSubmissionOrder[rhs_idx]);
+}
+
+inline bool DrawCmdHeadersMatch(const ImDrawCmd& lhs, const ImDrawCmd& rhs)
+{
+#if IMGUI_VERSION_NUM < 19200
+    const bool same_texture = memcmp(&lhs.TextureId, &rhs.TextureId, sizeof(lhs.TextureId)) == 0;
+#else
+    const bool same_texture = memcmp(&lhs.TexRef, &rhs.TexRef, sizeof(lhs.TexRef)) == 0;
+#endif
+    return same_texture && lhs.UserCallback == NULL && rhs.UserCallback == NULL &&
+           lhs.VtxOffset == rhs.VtxOffset &&
+           memcmp(&lhs.ClipRect, &rhs.ClipRect, sizeof(lhs.ClipRect)) == 0;
+}
+
+// Rebuilds the shared node channel's command and index buffers, so that each node's background
+// and foreground ranges are emitted in depth order. The vertex buffer is shared by all channels, so
+// the vertices don't need to move. Draw commands are split at range boundaries, and merged again
+// where consecutive pieces have the same clip rect and texture.
+void DrawListSortNodeDrawRangesByDepth(const ImVector<int>& submission_idx_depth_order)
+{
+    ImDrawListSplitter& splitter = GImNodes->CanvasDrawList->_Splitter;
+    // The buffers of the current channel are owned by the draw list, not the channel
+    IM_ASSERT(splitter._Current != 1);
+    ImDrawChannel&             channel = splitter._Channels[1];
+    const ImVector<ImDrawCmd>& cmds = channel._CmdBuffer;
+    const ImVector<ImDrawIdx>& indices = channel._IdxBuffer;
+
+    if (GImNodes->CurrentNodeDrawRangeIdx != -1)
+    {
+        GImNodes->NodeDrawRanges[GImNodes->CurrentNodeDrawRangeIdx].IdxEnd = indices.Size;
+        GImNodes->CurrentNodeDrawRangeIdx = -1;
+    }
+
+    ImVector<ImDrawCmd>& sorted_cmds = GImNodes->SortedNodeDrawCmds;
+    ImVector<ImDrawIdx>& sorted_indices = GImNodes->SortedNodeDrawIndices;
+    sorted_cmds.resize(0);
+    sorted_indices.resize(0);
+    sorted_indices.reserve(indices.Size);
+
+    for (int depth_idx = 0; depth_idx < submission_idx_depth_order.Size; ++depth_idx)
+    {
+        const int submission_idx = submission_idx_depth_order[depth_idx];
+
+        // The background range is followed by the foreground range
+        for (int range_idx = 2 * submission_idx; range_idx < 2 * submission_idx + 2; ++range_idx)
+        {
+            const ImNodeDrawRange& range = GImNodes->NodeDrawRanges[range_idx];
+
+            // Binary search for the first command which ends after the range begins. Callbacks
+            // don't contain any elements, and are kept with the range they were issued in.
+            int cmd_begin = 0;
+            int cmd_end = cmds.Size;
+            while (cmd_begin < cmd_end)
+            {
+                const int        cmd_mid = (cmd_begin + cmd_end) / 2;
+                const ImDrawCmd& cmd = cmds[cmd_mid];
+                if (static_cast<int>(cmd.IdxOffset + cmd.ElemCount) > range.IdxBegin ||
+                    static_cast<int>(cmd.IdxOffset) >= range.IdxBegin)
+                {
+                    cmd_end = cmd_mid;
+                }
+                else
+                {
+                    cmd_begin = cmd_mid + 1;
+                }
+            }
+
+            for (int cmd_idx = cmd_begin;
+                 cmd_idx < cmds.Size && static_cast<int>(cmds[cmd_idx].IdxOffset) < range.IdxEnd;
+                 ++cmd_idx)
+            {
+                const ImDrawCmd& cmd = cmds[cmd_idx];
+                const int        cmd_idx_begin = static_cast<int>(cmd.IdxOffset);
+                const int        cmd_idx_end = cmd_idx_begin + static_cast<int>(cmd.ElemCount);
+                const int        idx_begin = ImMax(cmd_idx_begin, range.IdxBegin);
+                const int        idx_end = ImMin(cmd_idx_end, range.IdxEnd);
+                const int        elem_count = ImMax(idx_end - idx_begin, 0);
+
+                if (cmd.UserCallback == NULL && elem_count == 0)
+                {
+                    continue;
+                }
+
+                if (!sorted_cmds.empty() && DrawCmdHeadersMatch(sorted_cmds.back(), cmd))
+                {
+                    sorted_cmds.back().ElemCount += elem_count;
+                }
+                else
+                {
+                    sorted_cmds.push_back(cmd);
+                    sorted_cmds.back().IdxOffset = sorted_indices.Size;
+                    sorted_cmds.back().ElemCount = elem_count;
+                }
+
+                const int sorted_idx_count = sorted_indices.Size;
+                sorted_indices.resize(sorted_idx_count + elem_count);
+                memcpy(
+                    sorted_indices.Data + sorted_idx_count,
+                    indices.Data + idx_begin,
+                    elem_count * sizeof(ImDrawIdx));
+            }
+        }
+    }
+
+    // Keep the channel's first command if nothing was rendered, like an unused channel would
+    if (sorted_cmds.empty())
+    {
+        sorted_cmds.push_back(cmds[0]);
+        sorted_cmds.back().ElemCount = 0;
+    }
+
+    channel._CmdBuffer.swap(sorted_cmds);
+    channel._IdxBuffer.swap(sorted_indices);
 }
 
-void DrawListSortChannelsByDepth(const ImVector<int>& node_idx_depth_order)
+void DrawListSortChannelsByDepth(const ImNodeDepthOrder& depth_order)
 {
-    if (GImNodes->NodeIdxToSubmissionIdx.Data.Size < 2)
+    // In the single node channel mode, a lone node's ranges still need to be sorted. Its background
+    // is rendered after its foreground.
+    if (GImNodes->NodeIdxSubmissionOrder.Size < (GImNodes->SingleNodeDrawChannel ? 1 : 2))
+    {
+        return;
+    }
+
+    // Map each depth to the submission idx of the node at that depth, i.e. to where the node's
+    // channels currently are. Nodes kept alive with IsNodeVisible() don't have any draw channels,
+    // so they are left out of the depth order used for sorting the channels.
+    ImVector<int>& submission_idx_depth_order = GImNodes->SubmissionIdxDepthOrder;
+    submission_idx_depth_order.resize(0);
+    bool in_depth_order = true;
+    for (int node_idx = depth_order.Bottom; node_idx != -1; node_idx = depth_order.Next[node_idx])
+    {
+        const int submission_idx = DrawListGetNodeSubmissionIdx(node_idx);
+        if (submission_idx != -1)
+        {
+            in_depth_order &= submission_idx == submission_idx_depth_order.Size;
+            submission_idx_depth_order.push_back(submission_idx);
+        }
+    }
+
+    IM_ASSERT(submission_idx_depth_order.Size == GImNodes->NodeIdxSubmissionOrder.Size);
+
+    if (GImNodes->SingleNodeDrawChannel)
     {
+        DrawListSortNodeDrawRangesByDepth(submission_idx_depth_order);
         return;
     }
 
-    IM_ASSERT(node_idx_depth_order.Size == GImNodes->NodeIdxSubmissionOrder.Size);
+    // early out if submission order and depth order are the same
+    if (in_depth_order)
+    {
+        return;
+    }
+
+    // Permute the channels in place by walking each cycle of the permutation. Every swap moves one
+    // node's channels into their final position, which is then marked as done by making it a fixed
+    // point of the permutation. This way the channels of each node are moved at most once.
+    for (int depth_idx = 0; depth_idx < submission_idx_depth_order.Size; ++depth_idx)
+    {
+        int dst_idx = depth_idx;
+        while (submission_idx_depth_order[dst_idx] != depth_idx)
+        {
+            const int src_idx = submission_idx_depth_order[dst_idx];
+            DrawListSwapSubmissionIndices(dst_idx, src_idx);
+            submission_idx_depth_order[dst_idx] = dst_idx;
+            dst_idx = src_idx;
+        }
+        submission_idx_depth_order[dst_idx] = dst_idx;
+    }
+}
+
+// [SECTION] ui state logic
+
+ImVec2 GetScreenSpacePinCoordinates(
+    const ImRect&              node_rect,
+    const ImRect&              attribute_rect,
+    const ImNodesAttributeType type)
+{
+    IM_ASSERT(type == ImNodesAttributeType_Input || type == ImNodesAttributeType_Output);
+    const float x = type == ImNodesAttributeType_Input
+                        ? (node_rect.Min.x - GImNodes->Style.PinOffset)
+                        : (node_rect.Max.x + GImNodes->Style.PinOffset);
+    return ImVec2(x, 0.5f * (attribute_rect.Min.y + attribute_rect.Max.y));
+}
 
-    int start_idx = node_idx_depth_order.Size - 1;
+ImVec2 GetScreenSpacePinCoordinates(const ImNodesEditorContext& editor, const int pin_idx)
+{
+    const ImPinData& pin = editor.Pins.Pool[pin_idx];
+    const ImRect&    parent_node_rect = editor.Nodes.Pool[pin.ParentNodeIdx].Rect;
+    return GetScreenSpacePinCoordinates(
+        parent_node_rect, editor.Pins.Cold[pin_idx].AttributeRect, pin.Type);
+}
 
-    while (node_idx_depth_order[start_idx] == GImNodes->NodeIdxSubmissionOrder[start_idx])
+void UpdatePinPositions(ImNodesEditorContext& editor, const ImNodeData& node)
+{
+    for (int i = 0; i < node.PinIndices.size(); ++i)
     {
-        if (--start_idx == 0)
+        const int    pin_idx = node.PinIndices[i];
+        ImPinData&   pin = editor.Pins.Pool[pin_idx];
+        const ImVec2 pos = GetScreenSpacePinCoordinates(
+            node.Rect, editor.Pins.Cold[pin_idx].AttributeRect, pin.Type);
+        if (pos.x != pin.Pos.x || pos.y != pin.Pos.y)
         {
-            // early out if submission order and depth order are the same
-            return;
+            pin.Pos = pos;
+            ++editor.SceneGeneration;
         }
     }
+}
 
-    // TODO: this is an O(N^2) algorithm. It might be worthwhile revisiting this to see if the time
-    // complexity can be reduced.
+void UpdateNodeGeometry(ImNodesEditorContext& editor)
+{
+    // Nodes are stored in the spatial grid with the area in which their pins can be hovered
+    const float pin_hover_extent =
+        ImFabs(GImNodes->Style.PinOffset) + GImNodes->Style.PinHoverRadius;
 
-    for (int depth_idx = start_idx; depth_idx > 0; --depth_idx)
+    for (int node_idx = 0; node_idx < editor.Nodes.Pool.size(); ++node_idx)
     {
-        const int node_idx = node_idx_depth_order[depth_idx];
+        ImNodeData& node = editor.Nodes.Pool[node_idx];
+
+        // Nodes which aren't submitted can't be hovered
+        const bool submitted = editor.Nodes.InUse[node_idx] && DrawListIsNodeSubmitted(node_idx);
+        if (node.Submitted != submitted)
+        {
+            node.Submitted = submitted;
+            ++editor.SceneGeneration;
+        }
+
+        if (!editor.Nodes.InUse[node_idx])
+        {
+            // An empty cell range removes unused nodes from the spatial grid
+            SpatialGridUpdateNode(editor.SpatialGrid, node_idx, ImSpatialGrid::CellRange());
+            continue;
+        }
 
-        // Find the current index of the node_idx in the submission order array
-        int submission_idx = -1;
-        for (int i = 0; i < GImNodes->NodeIdxSubmissionOrder.Size; ++i)
+        // A node kept alive with IsNodeVisible() wasn't laid out this frame. Move its rectangles
+        // to where the node would have been placed, in case the node or the canvas has moved
+        // since the node was last submitted.
+        if (!submitted)
         {
-            if (GImNodes->NodeIdxSubmissionOrder[i] == node_idx)
+            const ImVec2 delta = GridSpaceToScreenSpace(editor, node.Origin) - node.Rect.Min;
+            if (delta.x != 0.f || delta.y != 0.f)
             {
-                submission_idx = i;
-                break;
+                ++editor.SceneGeneration;
+            }
+            node.Rect.Translate(delta);
+            editor.Nodes.Cold[node_idx].TitleBarContentRect.Translate(delta);
+            for (int i = 0; i < node.PinIndices.size(); ++i)
+            {
+                editor.Pins.Cold[node.PinIndices[i]].AttributeRect.Translate(delta);
             }
+
+            editor.GridContentBounds.Add(node.Origin);
+            editor.GridContentBounds.Add(node.Origin + node.Rect.GetSize());
         }
-        IM_ASSERT(submission_idx >= 0);
 
-        if (submission_idx == depth_idx)
+        UpdatePinPositions(editor, node);
+
+        ImRect hover_rect = ScreenSpaceToGridSpace(editor, node.Rect);
+        hover_rect.Expand(pin_hover_extent);
+        SpatialGridUpdateNode(
+            editor.SpatialGrid,
+            node_idx,
+            SpatialGridGetCellRange(editor.SpatialGrid, hover_rect));
+    }
+}
+
+// A link can't outlive the pins it is attached to. This is relevant in retained mode, where links
+// stay alive without being submitted while their pins may have been removed.
+void FlagLinksToUnusedPinsAsUnused(ImNodesEditorContext& editor)
+{
+    for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
+    {
+        if (editor.Links.InUse[link_idx])
+        {
+            const ImLinkData& link = editor.Links.Pool[link_idx];
+            if (!editor.Pins.InUse[link.StartPinIdx] || !editor.Pins.InUse[link.EndPinIdx])
+            {
+                ObjectPoolSetInUse(editor.Links, link_idx, false);
+            }
+        }
+    }
+}
+
+void UpdateLinkGeometry(ImNodesEditorContext& editor)
+{
+    int  num_links = 0;
+    bool links_added = false;
+    bool links_moved = false;
+
+    for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
+    {
+        if (!editor.Links.InUse[link_idx])
         {
             continue;
         }
 
-        for (int j = submission_idx; j < depth_idx; ++j)
+        ++num_links;
+
+        ImLinkData&      link = editor.Links.Pool[link_idx];
+        const ImPinData& start_pin = editor.Pins.Pool[link.StartPinIdx];
+        const ImPinData& end_pin = editor.Pins.Pool[link.EndPinIdx];
+        const ImVec2     start = ScreenSpaceToGridSpace(editor, start_pin.Pos);
+        const ImVec2     end = ScreenSpaceToGridSpace(editor, end_pin.Pos);
+
+        if (start.x == link.GridSpaceStartPos.x && start.y == link.GridSpaceStartPos.y &&
+            end.x == link.GridSpaceEndPos.x && end.y == link.GridSpaceEndPos.y &&
+            link.LineSegmentsPerLength == GImNodes->Style.LinkLineSegmentsPerLength)
         {
-            DrawListSwapSubmissionIndices(j, j + 1);
-            ImSwap(GImNodes->NodeIdxSubmissionOrder[j], GImNodes->NodeIdxSubmissionOrder[j + 1]);
+            continue;
         }
-    }
-}
 
-// [SECTION] ui state logic
+        // The cached positions are only unset for links which were created since the last update
+        links_added |= link.GridSpaceStartPos.x == FLT_MAX;
+        links_moved = true;
 
-ImVec2 GetScreenSpacePinCoordinates(
-    const ImRect&              node_rect,
-    const ImRect&              attribute_rect,
-    const ImNodesAttributeType type)
-{
-    IM_ASSERT(type == ImNodesAttributeType_Input || type == ImNodesAttributeType_Output);
-    const float x = type == ImNodesAttributeType_Input
-                        ? (node_rect.Min.x - GImNodes->Style.PinOffset)
-                        : (node_rect.Max.x + GImNodes->Style.PinOffset);
-    return ImVec2(x, 0.5f * (attribute_rect.Min.y + attribute_rect.Max.y));
-}
+        const CubicBezier cubic_bezier =
+            GetCubicBezier(start, end, start_pin.Type, GImNodes->Style.LinkLineSegmentsPerLength);
+        EvalCubicBezierPolyline(cubic_bezier, link.GridSpacePolyline);
+        link.GridSpaceBounds = GetControlPointRectForCubicBezier(cubic_bezier);
+        link.GridSpaceStartPos = start;
+        link.GridSpaceEndPos = end;
+        link.LineSegmentsPerLength = GImNodes->Style.LinkLineSegmentsPerLength;
+    }
 
-ImVec2 GetScreenSpacePinCoordinates(const ImNodesEditorContext& editor, const ImPinData& pin)
-{
-    const ImRect& parent_node_rect = editor.Nodes.Pool[pin.ParentNodeIdx].Rect;
-    return GetScreenSpacePinCoordinates(parent_node_rect, pin.AttributeRect, pin.Type);
+    if (links_added || num_links != editor.LinkBvh.LinkIndices.size())
+    {
+        LinkBvhBuild(editor.LinkBvh, editor.Links);
+        ++editor.SceneGeneration;
+    }
+    else if (links_moved)
+    {
+        LinkBvhRefit(editor.LinkBvh, editor.Links);
+        ++editor.SceneGeneration;
+    }
 }
 
 bool MouseInCanvas()
@@ -573,6 +1392,36 @@ bool MouseInCanvas()
            GImNodes->CanvasRectScreenSpace.Contains(ImGui::GetMousePos());
 }
 
+// The selected indices are mirrored by the Selected flag of the objects, so that testing whether an
+// object is selected doesn't require searching the selection. The selection may only be modified
+// through these functions to keep the two in sync.
+
+template<typename T>
+void SelectionAdd(ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int idx)
+{
+    IM_ASSERT(!objects.Pool[idx].Selected);
+    objects.Pool[idx].Selected = true;
+    selected_indices.push_back(idx);
+}
+
+template<typename T>
+void SelectionRemove(ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int idx)
+{
+    IM_ASSERT(objects.Pool[idx].Selected);
+    objects.Pool[idx].Selected = false;
+    selected_indices.erase(selected_indices.find(idx));
+}
+
+template<typename T>
+void SelectionClear(ImObjectPool<T>& objects, ImVector<int>& selected_indices)
+{
+    for (int i = 0; i < selected_indices.size(); ++i)
+    {
+        objects.Pool[selected_indices[i]].Selected = false;
+    }
+    selected_indices.resize(0);
+}
+
 void BeginNodeSelection(ImNodesEditorContext& editor, const int node_idx)
 {
     // Don't start selecting a node if we are e.g. already creating and dragging
@@ -592,27 +1441,23 @@ void BeginNodeSelection(ImNodesEditorContext& editor, const int node_idx)
     //
     // Otherwise, we want to allow for the possibility of multiple nodes to be
     // moved at once.
-    if (!editor.SelectedNodeIndices.contains(node_idx))
+    if (!editor.Nodes.Pool[node_idx].Selected)
     {
-        editor.SelectedLinkIndices.clear();
+        SelectionClear(editor.Links, editor.SelectedLinkIndices);
         if (!GImNodes->MultipleSelectModifier)
         {
-            editor.SelectedNodeIndices.clear();
+            SelectionClear(editor.Nodes, editor.SelectedNodeIndices);
         }
-        editor.SelectedNodeIndices.push_back(node_idx);
+        SelectionAdd(editor.Nodes, editor.SelectedNodeIndices, node_idx);
 
         // Ensure that individually selected nodes get rendered on top
-        ImVector<int>&   depth_stack = editor.NodeDepthOrder;
-        const int* const elem = depth_stack.find(node_idx);
-        IM_ASSERT(elem != depth_stack.end());
-        depth_stack.erase(elem);
-        depth_stack.push_back(node_idx);
+        editor.NodeDepthOrder.MoveToTop(node_idx);
+        ++editor.SceneGeneration;
     }
     // Deselect a previously-selected node
     else if (GImNodes->MultipleSelectModifier)
     {
-        const int* const node_ptr = editor.SelectedNodeIndices.find(node_idx);
-        editor.SelectedNodeIndices.erase(node_ptr);
+        SelectionRemove(editor.Nodes, editor.SelectedNodeIndices, node_idx);
 
         // Don't allow dragging after deselecting
         editor.ClickInteraction.Type = ImNodesClickInteractionType_None;
@@ -624,7 +1469,7 @@ void BeginNodeSelection(ImNodesEditorContext& editor, const int node_idx)
     editor.PrimaryNodeOffset =
         ref_origin + GImNodes->CanvasOriginScreenSpace + editor.Panning - GImNodes->MousePos;
 
-    editor.SelectedNodeOffsets.clear();
+    editor.SelectedNodeOffsets.resize(0);
     for (int idx = 0; idx < editor.SelectedNodeIndices.Size; idx++)
     {
         const int    node = editor.SelectedNodeIndices[idx];
@@ -638,9 +1483,9 @@ void BeginLinkSelection(ImNodesEditorContext& editor, const int link_idx)
     editor.ClickInteraction.Type = ImNodesClickInteractionType_Link;
     // When a link is selected, clear all other selections, and insert the link
     // as the sole selection.
-    editor.SelectedNodeIndices.clear();
-    editor.SelectedLinkIndices.clear();
-    editor.SelectedLinkIndices.push_back(link_idx);
+    SelectionClear(editor.Nodes, editor.SelectedNodeIndices);
+    SelectionClear(editor.Links, editor.SelectedLinkIndices);
+    SelectionAdd(editor.Links, editor.SelectedLinkIndices, link_idx);
 }
 
 void BeginLinkDetach(ImNodesEditorContext& editor, const int link_idx, const int detach_pin_idx)
@@ -693,7 +1538,7 @@ void BeginLinkInteraction(
     {
         if (pin_idx.HasValue())
         {
-            const int hovered_pin_flags = editor.Pins.Pool[pin_idx.Value()].Flags;
+            const int hovered_pin_flags = editor.Pins.Cold[pin_idx.Value()].Flags;
 
             // Check the 'click and drag to detach' case.
             if (hovered_pin_flags & ImNodesAttributeFlags_EnableLinkDetachWithDragClick)
@@ -759,7 +1604,7 @@ void BoxSelectorUpdateSelection(ImNodesEditorContext& editor, ImRect box_rect)
 
     // Update node selection
 
-    editor.SelectedNodeIndices.clear();
+    SelectionClear(editor.Nodes, editor.SelectedNodeIndices);
 
     // Test for overlap against node rectangles
 
@@ -770,38 +1615,33 @@ void BoxSelectorUpdateSelection(ImNodesEditorContext& editor, ImRect box_rect)
             ImNodeData& node = editor.Nodes.Pool[node_idx];
             if (box_rect.Overlaps(node.Rect))
             {
-                editor.SelectedNodeIndices.push_back(node_idx);
+                SelectionAdd(editor.Nodes, editor.SelectedNodeIndices, node_idx);
             }
         }
     }
 
     // Update link selection
 
-    editor.SelectedLinkIndices.clear();
+    SelectionClear(editor.Links, editor.SelectedLinkIndices);
 
-    // Test for overlap against links
+    // Test for overlap against the links whose bounds overlap the box. The link bounds were
+    // computed before any auto-panning took place during this frame.
 
-    for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
-    {
-        if (editor.Links.InUse[link_idx])
-        {
-            const ImLinkData& link = editor.Links.Pool[link_idx];
+    ImRect query_rect = ScreenSpaceToGridSpace(editor, box_rect);
+    query_rect.Translate(editor.AutoPanningDelta);
 
-            const ImPinData& pin_start = editor.Pins.Pool[link.StartPinIdx];
-            const ImPinData& pin_end = editor.Pins.Pool[link.EndPinIdx];
-            const ImRect&    node_start_rect = editor.Nodes.Pool[pin_start.ParentNodeIdx].Rect;
-            const ImRect&    node_end_rect = editor.Nodes.Pool[pin_end.ParentNodeIdx].Rect;
+    ImVector<int>& link_indices = GImNodes->LinkIndicesOverlappingWithRect;
+    LinkBvhQuery(editor.LinkBvh, editor.Links, query_rect, link_indices);
 
-            const ImVec2 start = GetScreenSpacePinCoordinates(
-                node_start_rect, pin_start.AttributeRect, pin_start.Type);
-            const ImVec2 end =
-                GetScreenSpacePinCoordinates(node_end_rect, pin_end.AttributeRect, pin_end.Type);
+    for (int i = 0; i < link_indices.size(); ++i)
+    {
+        const int         link_idx = link_indices[i];
+        const ImLinkData& link = editor.Links.Pool[link_idx];
 
-            // Test
-            if (RectangleOverlapsLink(box_rect, start, end, pin_start.Type))
-            {
-                editor.SelectedLinkIndices.push_back(link_idx);
-            }
+        // Test
+        if (RectangleOverlapsLink(query_rect, link))
+        {
+            SelectionAdd(editor.Links, editor.SelectedLinkIndices, link_idx);
         }
     }
 }
@@ -849,47 +1689,18 @@ void TranslateSelectedNodes(ImNodesEditorContext& editor)
     }
 }
 
-struct LinkPredicate
-{
-    bool operator()(const ImLinkData& lhs, const ImLinkData& rhs) const
-    {
-        // Do a unique compare by sorting the pins' addresses.
-        // This catches duplicate links, whether they are in the
-        // same direction or not.
-        // Sorting by pin index should have the uniqueness guarantees as sorting
-        // by id -- each unique id will get one slot in the link pool array.
-
-        int lhs_start = lhs.StartPinIdx;
-        int lhs_end = lhs.EndPinIdx;
-        int rhs_start = rhs.StartPinIdx;
-        int rhs_end = rhs.EndPinIdx;
-
-        if (lhs_start > lhs_end)
-        {
-            ImSwap(lhs_start, lhs_end);
-        }
-
-        if (rhs_start > rhs_end)
-        {
-            ImSwap(rhs_start, rhs_end);
-        }
-
-        return lhs_start == rhs_start && lhs_end == rhs_end;
-    }
-};
-
 ImOptionalIndex FindDuplicateLink(
     const ImNodesEditorContext& editor,
     const int                   start_pin_idx,
     const int                   end_pin_idx)
 {
-    ImLinkData test_link(0);
-    test_link.StartPinIdx = start_pin_idx;
-    test_link.EndPinIdx = end_pin_idx;
-    for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
+    // The links connecting the same pins, whether they are in the same direction or not, are
+    // duplicates
+    for (int link_idx = editor.PinLinks.FindFirstLinkBetween(start_pin_idx, end_pin_idx);
+         link_idx != -1;
+         link_idx = editor.PinLinks.NextPairLinkIdx[link_idx])
     {
-        const ImLinkData& link = editor.Links.Pool[link_idx];
-        if (LinkPredicate()(test_link, link) && editor.Links.InUse[link_idx])
+        if (editor.Links.InUse[link_idx])
         {
             return ImOptionalIndex(link_idx);
         }
@@ -951,31 +1762,27 @@ void ClickInteractionUpdate(ImNodesEditorContext& editor)
 
         if (GImNodes->LeftMouseReleased)
         {
-            ImVector<int>&       depth_stack = editor.NodeDepthOrder;
+            ImNodeDepthOrder&    depth_order = editor.NodeDepthOrder;
             const ImVector<int>& selected_idxs = editor.SelectedNodeIndices;
 
-            // Bump the selected node indices, in order, to the top of the depth stack.
-            // NOTE: this algorithm has worst case time complexity of O(N^2), if the node selection
-            // is ~ N (due to selected_idxs.contains()).
-
-            if ((selected_idxs.Size > 0) && (selected_idxs.Size < depth_stack.Size))
+            // Bump the selected node indices, in order, to the top of the depth order. The nodes
+            // which were already in the depth order are visited once, so the nodes moved to the top
+            // aren't visited again.
+            if ((selected_idxs.Size > 0) && (selected_idxs.Size < depth_order.Size))
             {
-                int num_moved = 0; // The number of indices moved. Stop after selected_idxs.Size
-                for (int i = 0; i < depth_stack.Size - selected_idxs.Size; ++i)
+                const int last_node_idx = depth_order.Top;
+                int       node_idx = depth_order.Bottom;
+                while (node_idx != -1)
                 {
-                    for (int node_idx = depth_stack[i]; selected_idxs.contains(node_idx);
-                         node_idx = depth_stack[i])
-                    {
-                        depth_stack.erase(depth_stack.begin() + static_cast<size_t>(i));
-                        depth_stack.push_back(node_idx);
-                        ++num_moved;
-                    }
-
-                    if (num_moved == selected_idxs.Size)
+                    const int next_node_idx =
+                        node_idx == last_node_idx ? -1 : depth_order.Next[node_idx];
+                    if (editor.Nodes.Pool[node_idx].Selected)
                     {
-                        break;
+                        depth_order.MoveToTop(node_idx);
                     }
+                    node_idx = next_node_idx;
                 }
+                ++editor.SceneGeneration;
             }
 
             editor.ClickInteraction.Type = ImNodesClickInteractionType_None;
@@ -1033,13 +1840,13 @@ void ClickInteractionUpdate(ImNodesEditorContext& editor)
                 editor.ClickInteraction.LinkCreation.EndPinIdx.Value());
         }
 
-        const ImVec2 start_pos = GetScreenSpacePinCoordinates(editor, start_pin);
+        const ImVec2 start_pos = GetScreenSpacePinCoordinates(
+            editor, editor.ClickInteraction.LinkCreation.StartPinIdx);
         // If we are within the hover radius of a receiving pin, snap the link
         // endpoint to it
-        const ImVec2 end_pos = should_snap
-                                   ? GetScreenSpacePinCoordinates(
-                                         editor, editor.Pins.Pool[GImNodes->HoveredPinIdx.Value()])
-                                   : GImNodes->MousePos;
+        const ImVec2 end_pos =
+            should_snap ? GetScreenSpacePinCoordinates(editor, GImNodes->HoveredPinIdx.Value())
+                        : GImNodes->MousePos;
 
         const CubicBezier cubic_bezier = GetCubicBezier(
             start_pos, end_pos, start_pin.Type, GImNodes->Style.LinkLineSegmentsPerLength);
@@ -1058,7 +1865,7 @@ void ClickInteractionUpdate(ImNodesEditorContext& editor)
 
         const bool link_creation_on_snap =
             GImNodes->HoveredPinIdx.HasValue() &&
-            (editor.Pins.Pool[GImNodes->HoveredPinIdx.Value()].Flags &
+            (editor.Pins.Cold[GImNodes->HoveredPinIdx.Value()].Flags &
              ImNodesAttributeFlags_EnableLinkCreationOnSnap);
 
         if (!should_snap)
@@ -1122,117 +1929,131 @@ void ClickInteractionUpdate(ImNodesEditorContext& editor)
     }
 }
 
-void ResolveOccludedPins(const ImNodesEditorContext& editor, ImVector<int>& occluded_pin_indices)
+// Returns true if the node can be hovered this frame. Nodes which were kept alive without being
+// submitted aren't rendered, and can't be interacted with.
+inline bool IsNodeHoverable(const ImNodesEditorContext& editor, const int node_idx)
 {
-    const ImVector<int>& depth_stack = editor.NodeDepthOrder;
+    return editor.Nodes.InUse[node_idx] && DrawListIsNodeSubmitted(node_idx);
+}
 
-    occluded_pin_indices.resize(0);
+// Returns true if the pin's position is covered by a node above the pin's node in the depth order.
+// The nodes containing the position are all found in the position's grid cell, and their depth is
+// compared by rank, so only the pins which would otherwise be hovered need to be tested.
+bool IsPinOccluded(const ImNodesEditorContext& editor, const int pin_idx)
+{
+    const ImPinData&     pin = editor.Pins.Pool[pin_idx];
+    const ImVector<int>& depth_rank = editor.NodeDepthOrder.Rank;
+    const int            parent_rank = depth_rank[pin.ParentNodeIdx];
 
-    if (depth_stack.Size < 2)
-    {
-        return;
-    }
+    const int cell_head =
+        SpatialGridFindCell(editor.SpatialGrid, ScreenSpaceToGridSpace(editor, pin.Pos));
 
-    // For each node in the depth stack
-    for (int depth_idx = 0; depth_idx < (depth_stack.Size - 1); ++depth_idx)
+    for (int entry_idx = cell_head; entry_idx != -1;
+         entry_idx = editor.SpatialGrid.Entries[entry_idx].Next)
     {
-        const ImNodeData& node_below = editor.Nodes.Pool[depth_stack[depth_idx]];
-
-        // Iterate over the rest of the depth stack to find nodes overlapping the pins
-        for (int next_depth_idx = depth_idx + 1; next_depth_idx < depth_stack.Size;
-             ++next_depth_idx)
+        // Nodes which weren't submitted this frame aren't drawn, so they can't occlude the pin
+        const int node_idx = editor.SpatialGrid.Entries[entry_idx].NodeIdx;
+        if (IsNodeHoverable(editor, node_idx) && depth_rank[node_idx] > parent_rank &&
+            editor.Nodes.Pool[node_idx].Rect.Contains(pin.Pos))
         {
-            const ImRect& rect_above = editor.Nodes.Pool[depth_stack[next_depth_idx]].Rect;
-
-            // Iterate over each pin
-            for (int idx = 0; idx < node_below.PinIndices.Size; ++idx)
-            {
-                const int     pin_idx = node_below.PinIndices[idx];
-                const ImVec2& pin_pos = editor.Pins.Pool[pin_idx].Pos;
-
-                if (rect_above.Contains(pin_pos))
-                {
-                    occluded_pin_indices.push_back(pin_idx);
-                }
-            }
+            return true;
         }
     }
+
+    return false;
 }
 
-ImOptionalIndex ResolveHoveredPin(
-    const ImObjectPool<ImPinData>& pins,
-    const ImVector<int>&           occluded_pin_indices)
+ImOptionalIndex ResolveHoveredPin(const ImNodesEditorContext& editor)
 {
     float           smallest_distance = FLT_MAX;
     ImOptionalIndex pin_idx_with_smallest_distance;
 
     const float hover_radius_sqr = GImNodes->Style.PinHoverRadius * GImNodes->Style.PinHoverRadius;
 
-    for (int idx = 0; idx < pins.Pool.Size; ++idx)
-    {
-        if (!pins.InUse[idx])
-        {
-            continue;
-        }
+    // Only the pins of the nodes in the mouse cursor's grid cell can be within hover distance
+    const int cell_head =
+        SpatialGridFindCell(editor.SpatialGrid, ScreenSpaceToGridSpace(editor, GImNodes->MousePos));
 
-        if (occluded_pin_indices.contains(idx))
+    for (int entry_idx = cell_head; entry_idx != -1;
+         entry_idx = editor.SpatialGrid.Entries[entry_idx].Next)
+    {
+        const int node_idx = editor.SpatialGrid.Entries[entry_idx].NodeIdx;
+        if (!IsNodeHoverable(editor, node_idx))
         {
             continue;
         }
 
-        const ImVec2& pin_pos = pins.Pool[idx].Pos;
-        const float   distance_sqr = ImLengthSqr(pin_pos - GImNodes->MousePos);
-
-        // TODO: GImNodes->Style.PinHoverRadius needs to be copied into pin data and the pin-local
-        // value used here. This is no longer called in BeginAttribute/EndAttribute scope and the
-        // detected pin might have a different hover radius than what the user had when calling
-        // BeginAttribute/EndAttribute.
-        if (distance_sqr < hover_radius_sqr && distance_sqr < smallest_distance)
+        const ImNodeData& node = editor.Nodes.Pool[node_idx];
+        for (int i = 0; i < node.PinIndices.size(); ++i)
         {
-            smallest_distance = distance_sqr;
-            pin_idx_with_smallest_distance = idx;
+            const int     idx = node.PinIndices[i];
+            const ImVec2& pin_pos = editor.Pins.Pool[idx].Pos;
+            const float   distance_sqr = ImLengthSqr(pin_pos - GImNodes->MousePos);
+
+            // TODO: GImNodes->Style.PinHoverRadius needs to be copied into pin data and the
+            // pin-local value used here. This is no longer called in BeginAttribute/EndAttribute
+            // scope and the detected pin might have a different hover radius than what the user
+            // had when calling BeginAttribute/EndAttribute.
+            if (distance_sqr < hover_radius_sqr && distance_sqr < smallest_distance &&
+                !IsPinOccluded(editor, idx))
+            {
+                smallest_distance = distance_sqr;
+                pin_idx_with_smallest_distance = idx;
+            }
         }
     }
 
     return pin_idx_with_smallest_distance;
 }
 
-ImOptionalIndex ResolveHoveredNode(const ImVector<int>& depth_stack)
+ImOptionalIndex ResolveHoveredNode(const ImNodesEditorContext& editor)
 {
-    if (GImNodes->NodeIndicesOverlappingWithMouse.size() == 0)
+    ImVector<int>& overlapping_node_indices = GImNodes->NodeIndicesOverlappingWithMouse;
+    overlapping_node_indices.resize(0);
+
+    const int cell_head =
+        SpatialGridFindCell(editor.SpatialGrid, ScreenSpaceToGridSpace(editor, GImNodes->MousePos));
+
+    for (int entry_idx = cell_head; entry_idx != -1;
+         entry_idx = editor.SpatialGrid.Entries[entry_idx].Next)
     {
-        return ImOptionalIndex();
+        const int node_idx = editor.SpatialGrid.Entries[entry_idx].NodeIdx;
+        if (IsNodeHoverable(editor, node_idx) &&
+            editor.Nodes.Pool[node_idx].Rect.Contains(GImNodes->MousePos))
+        {
+            overlapping_node_indices.push_back(node_idx);
+        }
     }
 
-    if (GImNodes->NodeIndicesOverlappingWithMouse.size() == 1)
+    if (overlapping_node_indices.size() == 0)
     {
-        return ImOptionalIndex(GImNodes->NodeIndicesOverlappingWithMouse[0]);
+        return ImOptionalIndex();
     }
 
-    int largest_depth_idx = -1;
-    int node_idx_on_top = -1;
+    if (overlapping_node_indices.size() == 1)
+    {
+        return ImOptionalIndex(overlapping_node_indices[0]);
+    }
 
-    for (int i = 0; i < GImNodes->NodeIndicesOverlappingWithMouse.size(); ++i)
+    // The node closest to the top of the depth order is the one being hovered
+    const ImVector<int>& depth_rank = editor.NodeDepthOrder.Rank;
+    int                  top_node_idx = overlapping_node_indices[0];
+    for (int i = 1; i < overlapping_node_indices.Size; ++i)
     {
-        const int node_idx = GImNodes->NodeIndicesOverlappingWithMouse[i];
-        for (int depth_idx = 0; depth_idx < depth_stack.size(); ++depth_idx)
+        const int node_idx = overlapping_node_indices[i];
+        if (depth_rank[node_idx] > depth_rank[top_node_idx])
         {
-            if (depth_stack[depth_idx] == node_idx && (depth_idx > largest_depth_idx))
-            {
-                largest_depth_idx = depth_idx;
-                node_idx_on_top = node_idx;
-            }
+            top_node_idx = node_idx;
         }
     }
 
-    IM_ASSERT(node_idx_on_top != -1);
-    return ImOptionalIndex(node_idx_on_top);
+    return ImOptionalIndex(top_node_idx);
 }
 
-ImOptionalIndex ResolveHoveredLink(
-    const ImObjectPool<ImLinkData>& links,
-    const ImObjectPool<ImPinData>&  pins)
+ImOptionalIndex ResolveHoveredLink(const ImNodesEditorContext& editor)
 {
+    const ImObjectPool<ImLinkData>& links = editor.Links;
+
     float           smallest_distance = FLT_MAX;
     ImOptionalIndex link_idx_with_smallest_distance;
 
@@ -1244,54 +2065,50 @@ ImOptionalIndex ResolveHoveredLink(
     // The latter is a requirement for link detaching with drag click to work, as both a link and
     // pin are required to be hovered over for the feature to work.
 
-    for (int idx = 0; idx < links.Pool.Size; ++idx)
+    // If there is a hovered pin links can only be considered hovered if they use that pin
+    if (GImNodes->HoveredPinIdx.HasValue())
     {
-        if (!links.InUse[idx])
-        {
-            continue;
-        }
-
-        const ImLinkData& link = links.Pool[idx];
-        const ImPinData&  start_pin = pins.Pool[link.StartPinIdx];
-        const ImPinData&  end_pin = pins.Pool[link.EndPinIdx];
-
-        // If there is a hovered pin links can only be considered hovered if they use that pin
-        if (GImNodes->HoveredPinIdx.HasValue())
+        int       first;
+        const int num_links =
+            PinLinkIndexGetLinks(editor.PinLinks, GImNodes->HoveredPinIdx.Value(), &first);
+        for (int i = first; i < first + num_links; ++i)
         {
-            if (GImNodes->HoveredPinIdx == link.StartPinIdx ||
-                GImNodes->HoveredPinIdx == link.EndPinIdx)
+            const int idx = editor.PinLinks.LinkIndices[i];
+            if (links.InUse[idx])
             {
                 return idx;
             }
-            continue;
         }
 
-        // TODO: the calculated CubicBeziers could be cached since we generate them again when
-        // rendering the links
+        return ImOptionalIndex();
+    }
 
-        const CubicBezier cubic_bezier = GetCubicBezier(
-            start_pin.Pos, end_pin.Pos, start_pin.Type, GImNodes->Style.LinkLineSegmentsPerLength);
+    // Only the links whose bounds are within hover distance of the mouse need to be tested
+    const float  hover_distance = GImNodes->Style.LinkHoverDistance;
+    const ImVec2 mouse_pos = ScreenSpaceToGridSpace(editor, GImNodes->MousePos);
+    ImRect       query_rect(mouse_pos, mouse_pos);
+    query_rect.Expand(ImVec2(hover_distance, hover_distance));
+
+    ImVector<int>& link_indices = GImNodes->LinkIndicesOverlappingWithRect;
+    LinkBvhQuery(editor.LinkBvh, links, query_rect, link_indices);
+
+    for (int i = 0; i < link_indices.size(); ++i)
+    {
+        const int         idx = link_indices[i];
+        const ImLinkData& link = links.Pool[idx];
 
         // The distance test
         {
-            const ImRect link_rect = GetContainingRectForCubicBezier(cubic_bezier);
+            const float distance = GetDistanceToPolyline(mouse_pos, link.GridSpacePolyline);
 
-            // First, do a simple bounding box test against the box containing the link
-            // to see whether calculating the distance to the link is worth doing.
-            if (link_rect.Contains(GImNodes->MousePos))
+            // TODO: GImNodes->Style.LinkHoverDistance could be also copied into ImLinkData, since
+            // we're not calling this function in the same scope as ImNodes::Link(). The
+            // rendered/detected link might have a different hover distance than what the user had
+            // specified when calling Link()
+            if (distance < hover_distance && distance < smallest_distance)
             {
-                const float distance = GetDistanceToCubicBezier(
-                    GImNodes->MousePos, cubic_bezier, cubic_bezier.NumSegments);
-
-                // TODO: GImNodes->Style.LinkHoverDistance could be also copied into ImLinkData,
-                // since we're not calling this function in the same scope as ImNodes::Link(). The
-                // rendered/detected link might have a different hover distance than what the user
-                // had specified when calling Link()
-                if (distance < GImNodes->Style.LinkHoverDistance && distance < smallest_distance)
-                {
-                    smallest_distance = distance;
-                    link_idx_with_smallest_distance = idx;
-                }
+                smallest_distance = distance;
+                link_idx_with_smallest_distance = idx;
             }
         }
     }
@@ -1299,26 +2116,65 @@ ImOptionalIndex ResolveHoveredLink(
     return link_idx_with_smallest_distance;
 }
 
+// Returns true if the hovered objects were resolved from the same scene and mouse position during
+// an earlier frame.
+bool HoverCacheIsValid(const ImNodesEditorContext& editor)
+{
+    const ImHoverCache& cache = editor.HoverCache;
+    return cache.Valid && cache.SceneGeneration == editor.SceneGeneration &&
+           cache.MousePos.x == GImNodes->MousePos.x && cache.MousePos.y == GImNodes->MousePos.y &&
+           cache.Panning.x == editor.Panning.x && cache.Panning.y == editor.Panning.y &&
+           cache.PinHoverRadius == GImNodes->Style.PinHoverRadius &&
+           cache.LinkHoverDistance == GImNodes->Style.LinkHoverDistance &&
+           cache.NumNodesInUse == editor.Nodes.NumInUse &&
+           cache.NumPinsInUse == editor.Pins.NumInUse &&
+           cache.NumLinksInUse == editor.Links.NumInUse;
+}
+
+void HoverCacheStore(ImNodesEditorContext& editor)
+{
+    ImHoverCache& cache = editor.HoverCache;
+    cache.Valid = true;
+    cache.SceneGeneration = editor.SceneGeneration;
+    cache.MousePos = GImNodes->MousePos;
+    cache.Panning = editor.Panning;
+    cache.PinHoverRadius = GImNodes->Style.PinHoverRadius;
+    cache.LinkHoverDistance = GImNodes->Style.LinkHoverDistance;
+    cache.NumNodesInUse = editor.Nodes.NumInUse;
+    cache.NumPinsInUse = editor.Pins.NumInUse;
+    cache.NumLinksInUse = editor.Links.NumInUse;
+    cache.HoveredNodeIdx = GImNodes->HoveredNodeIdx;
+    cache.HoveredPinIdx = GImNodes->HoveredPinIdx;
+    cache.HoveredLinkIdx = GImNodes->HoveredLinkIdx;
+}
+
 // [SECTION] render helpers
 
 inline ImRect GetItemRect() { return ImRect(ImGui::GetItemRectMin(), ImGui::GetItemRectMax()); }
 
-inline ImVec2 GetNodeTitleBarOrigin(const ImNodeData& node)
+inline ImVec2 GetNodeTitleBarOrigin(const ImNodeData& node, const ImNodeStyleData& node_style)
 {
-    return node.Origin + node.LayoutStyle.Padding;
+    return node.Origin + node_style.LayoutStyle.Padding;
 }
 
-inline ImVec2 GetNodeContentOrigin(const ImNodeData& node)
+inline ImVec2 GetNodeContentOrigin(
+    const ImNodeData&      node,
+    const ImNodeColdData&  node_cold,
+    const ImNodeStyleData& node_style)
 {
-    const ImVec2 title_bar_height =
-        ImVec2(0.f, node.TitleBarContentRect.GetHeight() + 2.0f * node.LayoutStyle.Padding.y);
-    return node.Origin + title_bar_height + node.LayoutStyle.Padding;
+    const ImVec2 title_bar_height = ImVec2(
+        0.f,
+        node_cold.TitleBarContentRect.GetHeight() + 2.0f * node_style.LayoutStyle.Padding.y);
+    return node.Origin + title_bar_height + node_style.LayoutStyle.Padding;
 }
 
-inline ImRect GetNodeTitleRect(const ImNodeData& node)
+inline ImRect GetNodeTitleRect(
+    const ImNodeData&      node,
+    const ImNodeColdData&  node_cold,
+    const ImNodeStyleData& node_style)
 {
-    ImRect expanded_title_rect = node.TitleBarContentRect;
-    expanded_title_rect.Expand(node.LayoutStyle.Padding);
+    ImRect expanded_title_rect = node_cold.TitleBarContentRect;
+    expanded_title_rect.Expand(node_style.LayoutStyle.Padding);
 
     return ImRect(
         expanded_title_rect.Min,
@@ -1326,6 +2182,19 @@ inline ImRect GetNodeTitleRect(const ImNodeData& node)
             ImVec2(0.f, expanded_title_rect.GetHeight()));
 }
 
+// Returns a screen space rectangle containing everything DrawNode() renders for a node with the
+// given rectangle, including the pins which stick out of the node's sides.
+ImRect GetNodeDrawRect(const ImRect& node_rect)
+{
+    const ImNodesStyle& style = GImNodes->Style;
+    const float         pin_size =
+        ImMax(style.PinCircleRadius, ImMax(style.PinQuadSideLength, style.PinTriangleSideLength));
+
+    ImRect rect = node_rect;
+    rect.Expand(ImFabs(style.PinOffset) + pin_size + style.PinLineThickness);
+    return rect;
+}
+
 void DrawGrid(ImNodesEditorContext& editor, const ImVec2& canvas_size)
 {
     const ImVec2 offset = editor.Panning;
@@ -1400,11 +2269,11 @@ TriangleOffsets CalculateTriangleOffsets(const float side_length)
     return offset;
 }
 
-void DrawPinShape(const ImVec2& pin_pos, const ImPinData& pin, const ImU32 pin_color)
+void DrawPinShape(const ImVec2& pin_pos, const ImNodesPinShape pin_shape, const ImU32 pin_color)
 {
     static const int CIRCLE_NUM_SEGMENTS = 8;
 
-    switch (pin.Shape)
+    switch (pin_shape)
     {
     case ImNodesPinShape_Circle:
     {
@@ -1480,67 +2349,68 @@ void DrawPinShape(const ImVec2& pin_pos, const ImPinData& pin, const ImU32 pin_c
 
 void DrawPin(ImNodesEditorContext& editor, const int pin_idx)
 {
-    ImPinData&    pin = editor.Pins.Pool[pin_idx];
-    const ImRect& parent_node_rect = editor.Nodes.Pool[pin.ParentNodeIdx].Rect;
+    const ImPinData&      pin = editor.Pins.Pool[pin_idx];
+    const ImPinColdData&  pin_cold = editor.Pins.Cold[pin_idx];
+    const ImPinStyleData& pin_style = editor.PinStyles.Styles[pin_cold.StyleIdx];
 
-    pin.Pos = GetScreenSpacePinCoordinates(parent_node_rect, pin.AttributeRect, pin.Type);
-
-    ImU32 pin_color = pin.ColorStyle.Background;
+    ImU32 pin_color = pin_style.ColorStyle.Background;
 
     if (GImNodes->HoveredPinIdx == pin_idx)
     {
-        pin_color = pin.ColorStyle.Hovered;
+        pin_color = pin_style.ColorStyle.Hovered;
     }
 
-    DrawPinShape(pin.Pos, pin, pin_color);
+    DrawPinShape(pin.Pos, pin_cold.Shape, pin_color);
 }
 
 void DrawNode(ImNodesEditorContext& editor, const int node_idx)
 {
-    const ImNodeData& node = editor.Nodes.Pool[node_idx];
+    const ImNodeData&      node = editor.Nodes.Pool[node_idx];
+    const ImNodeColdData&  node_cold = editor.Nodes.Cold[node_idx];
+    const ImNodeStyleData& node_style = editor.NodeStyles.Styles[node_cold.StyleIdx];
     ImGui::SetCursorPos(node.Origin + editor.Panning);
 
     const bool node_hovered =
         GImNodes->HoveredNodeIdx == node_idx &&
         editor.ClickInteraction.Type != ImNodesClickInteractionType_BoxSelection;
 
-    ImU32 node_background = node.ColorStyle.Background;
-    ImU32 titlebar_background = node.ColorStyle.Titlebar;
+    ImU32 node_background = node_style.ColorStyle.Background;
+    ImU32 titlebar_background = node_style.ColorStyle.Titlebar;
 
-    if (editor.SelectedNodeIndices.contains(node_idx))
+    if (node.Selected)
     {
-        node_background = node.ColorStyle.BackgroundSelected;
-        titlebar_background = node.ColorStyle.TitlebarSelected;
+        node_background = node_style.ColorStyle.BackgroundSelected;
+        titlebar_background = node_style.ColorStyle.TitlebarSelected;
     }
     else if (node_hovered)
     {
-        node_background = node.ColorStyle.BackgroundHovered;
-        titlebar_background = node.ColorStyle.TitlebarHovered;
+        node_background = node_style.ColorStyle.BackgroundHovered;
+        titlebar_background = node_style.ColorStyle.TitlebarHovered;
     }
 
     {
         // node base
         GImNodes->CanvasDrawList->AddRectFilled(
-            node.Rect.Min, node.Rect.Max, node_background, node.LayoutStyle.CornerRounding);
+            node.Rect.Min, node.Rect.Max, node_background, node_style.LayoutStyle.CornerRounding);
 
         // title bar:
-        if (node.TitleBarContentRect.GetHeight() > 0.f)
+        if (node_cold.TitleBarContentRect.GetHeight() > 0.f)
         {
-            ImRect title_bar_rect = GetNodeTitleRect(node);
+            ImRect title_bar_rect = GetNodeTitleRect(node, node_cold, node_style);
 
 #if IMGUI_VERSION_NUM < 18200
             GImNodes->CanvasDrawList->AddRectFilled(
                 title_bar_rect.Min,
                 title_bar_rect.Max,
                 titlebar_background,
-                node.LayoutStyle.CornerRounding,
+                node_style.LayoutStyle.CornerRounding,
                 ImDrawCornerFlags_Top);
 #else
             GImNodes->CanvasDrawList->AddRectFilled(
                 title_bar_rect.Min,
                 title_bar_rect.Max,
                 titlebar_background,
-                node.LayoutStyle.CornerRounding,
+                node_style.LayoutStyle.CornerRounding,
                 ImDrawFlags_RoundCornersTop);
 
 #endif
@@ -1552,25 +2422,25 @@ void DrawNode(ImNodesEditorContext& editor, const int node_idx)
             GImNodes->CanvasDrawList->AddRect(
                 node.Rect.Min,
                 node.Rect.Max,
-                node.ColorStyle.Outline,
-                node.LayoutStyle.CornerRounding,
+                node_style.ColorStyle.Outline,
+                node_style.LayoutStyle.CornerRounding,
                 ImDrawCornerFlags_All,
-                node.LayoutStyle.BorderThickness);
+                node_style.LayoutStyle.BorderThickness);
 #elif IMGUI_VERSION_NUM < 19276
             GImNodes->CanvasDrawList->AddRect(
                 node.Rect.Min,
                 node.Rect.Max,
-                node.ColorStyle.Outline,
-                node.LayoutStyle.CornerRounding,
+                node_style.ColorStyle.Outline,
+                node_style.LayoutStyle.CornerRounding,
                 ImDrawFlags_RoundCornersAll,
-                node.LayoutStyle.BorderThickness);
+                node_style.LayoutStyle.BorderThickness);
 #else
             GImNodes->CanvasDrawList->AddRect(
                 node.Rect.Min,
                 node.Rect.Max,
-                node.ColorStyle.Outline,
-                node.LayoutStyle.CornerRounding,
-                node.LayoutStyle.BorderThickness,
+                node_style.ColorStyle.Outline,
+                node_style.LayoutStyle.CornerRounding,
+                node_style.LayoutStyle.BorderThickness,
                 ImDrawFlags_RoundCornersAll);
 #endif
         }
@@ -1590,11 +2460,6 @@ void DrawNode(ImNodesEditorContext& editor, const int node_idx)
 void DrawLink(ImNodesEditorContext& editor, const int link_idx)
 {
     const ImLinkData& link = editor.Links.Pool[link_idx];
-    const ImPinData&  start_pin = editor.Pins.Pool[link.StartPinIdx];
-    const ImPinData&  end_pin = editor.Pins.Pool[link.EndPinIdx];
-
-    const CubicBezier cubic_bezier = GetCubicBezier(
-        start_pin.Pos, end_pin.Pos, start_pin.Type, GImNodes->Style.LinkLineSegmentsPerLength);
 
     const bool link_hovered =
         GImNodes->HoveredLinkIdx == link_idx &&
@@ -1615,28 +2480,49 @@ void DrawLink(ImNodesEditorContext& editor, const int link_idx)
         return;
     }
 
-    ImU32 link_color = link.ColorStyle.Base;
-    if (editor.SelectedLinkIndices.contains(link_idx))
+    // Don't bother emitting links which are entirely outside of the canvas
+    const float hover_distance = GImNodes->Style.LinkHoverDistance;
+    ImRect      link_rect = GridSpaceToScreenSpace(editor, link.GridSpaceBounds);
+    link_rect.Expand(ImVec2(hover_distance, hover_distance));
+    if (!GImNodes->CanvasRectScreenSpace.Overlaps(link_rect))
+    {
+        GImNodes->FrameStats.LinksCulled++;
+        return;
+    }
+    GImNodes->FrameStats.LinksDrawn++;
+
+    const ImLinkStyleData& link_style =
+        editor.LinkStyles.Styles[editor.Links.Cold[link_idx].StyleIdx];
+    ImU32 link_color = link_style.ColorStyle.Base;
+    if (link.Selected)
     {
-        link_color = link.ColorStyle.Selected;
+        link_color = link_style.ColorStyle.Selected;
     }
     else if (link_hovered)
     {
-        link_color = link.ColorStyle.Hovered;
+        link_color = link_style.ColorStyle.Hovered;
     }
 
-#if IMGUI_VERSION_NUM < 18000
-    GImNodes->CanvasDrawList->AddBezierCurve(
+    // The curve was flattened in grid space when the link last moved, so only a translation is
+    // needed here.
+    const ImVec2      offset = GImNodes->CanvasOriginScreenSpace + editor.Panning;
+    ImVector<ImVec2>& points = GImNodes->LinkPolylineScreenSpace;
+    points.resize(link.GridSpacePolyline.size());
+    for (int i = 0; i < points.size(); ++i)
+    {
+        points[i] = link.GridSpacePolyline[i] + offset;
+    }
+
+    GImNodes->CanvasDrawList->AddPolyline(
+        points.Data,
+        points.Size,
+        link_color,
+#if IMGUI_VERSION_NUM < 18200
+        false,
 #else
-    GImNodes->CanvasDrawList->AddBezierCubic(
+        ImDrawFlags_None,
 #endif
-        cubic_bezier.P0,
-        cubic_bezier.P1,
-        cubic_bezier.P2,
-        cubic_bezier.P3,
-        link_color,
-        GImNodes->Style.LinkThickness,
-        cubic_bezier.NumSegments);
+        GImNodes->Style.LinkThickness);
 }
 
 void BeginPinAttribute(
@@ -1650,6 +2536,8 @@ void BeginPinAttribute(
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Node);
     GImNodes->CurrentScope = ImNodesScope_Attribute;
 
+    const AllocationCounterScope allocation_scope;
+
     ImGui::BeginGroup();
     ImGui::PushID(id);
 
@@ -1659,14 +2547,19 @@ void BeginPinAttribute(
 
     const int pin_idx = ObjectPoolFindOrCreateIndex(editor.Pins, id);
     GImNodes->CurrentPinIdx = pin_idx;
+    GImNodes->FrameStats.PinsSubmitted++;
     ImPinData& pin = editor.Pins.Pool[pin_idx];
     pin.Id = id;
     pin.ParentNodeIdx = node_idx;
     pin.Type = type;
-    pin.Shape = shape;
-    pin.Flags = GImNodes->CurrentAttributeFlags;
-    pin.ColorStyle.Background = GImNodes->Style.Colors[ImNodesCol_Pin];
-    pin.ColorStyle.Hovered = GImNodes->Style.Colors[ImNodesCol_PinHovered];
+    ImPinColdData& pin_cold = editor.Pins.Cold[pin_idx];
+    pin_cold.Shape = shape;
+    pin_cold.Flags = GImNodes->CurrentAttributeFlags;
+
+    ImPinStyleData pin_style;
+    pin_style.ColorStyle.Background = GImNodes->Style.Colors[ImNodesCol_Pin];
+    pin_style.ColorStyle.Hovered = GImNodes->Style.Colors[ImNodesCol_PinHovered];
+    pin_cold.StyleIdx = editor.PinStyles.Intern(pin_style);
 }
 
 void EndPinAttribute()
@@ -1674,6 +2567,8 @@ void EndPinAttribute()
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Attribute);
     GImNodes->CurrentScope = ImNodesScope_Node;
 
+    const AllocationCounterScope allocation_scope;
+
     ImGui::PopID();
     ImGui::EndGroup();
 
@@ -1684,9 +2579,8 @@ void EndPinAttribute()
     }
 
     ImNodesEditorContext& editor = EditorContextGet();
-    ImPinData&            pin = editor.Pins.Pool[GImNodes->CurrentPinIdx];
     ImNodeData&           node = editor.Nodes.Pool[GImNodes->CurrentNodeIdx];
-    pin.AttributeRect = GetItemRect();
+    editor.Pins.Cold[GImNodes->CurrentPinIdx].AttributeRect = GetItemRect();
     node.PinIndices.push_back(GImNodes->CurrentPinIdx);
 }
 
@@ -1708,7 +2602,11 @@ void Initialize(ImNodesContext* context)
     StyleColorsDark(&context->Style);
 }
 
-void Shutdown(ImNodesContext* ctx) { EditorContextFree(ctx->DefaultEditorCtx); }
+void Shutdown(ImNodesContext* ctx)
+{
+    EditorContextFree(ctx->DefaultEditorCtx);
+    AllocationCounterSetEnabled(*ctx, false);
+}
 
 // [SECTION] minimap
 
@@ -1790,13 +2688,15 @@ static inline void CalcMiniMapLayout()
 
 static void MiniMapDrawNode(ImNodesEditorContext& editor, const int node_idx)
 {
-    const ImNodeData& node = editor.Nodes.Pool[node_idx];
+    const ImNodeData&      node = editor.Nodes.Pool[node_idx];
+    const ImNodeStyleData& node_style =
+        editor.NodeStyles.Styles[editor.Nodes.Cold[node_idx].StyleIdx];
 
     const ImRect node_rect = ScreenSpaceToMiniMapSpace(editor, node.Rect);
 
     // Round to near whole pixel value for corner-rounding to prevent visual glitches
     const float mini_map_node_rounding =
-        floorf(node.LayoutStyle.CornerRounding * editor.MiniMapScaling);
+        floorf(node_style.LayoutStyle.CornerRounding * editor.MiniMapScaling);
 
     ImU32 mini_map_node_background;
 
@@ -1811,7 +2711,7 @@ static void MiniMapDrawNode(ImNodesEditorContext& editor, const int node_idx)
             editor.MiniMapNodeHoveringCallback(node.Id, editor.MiniMapNodeHoveringCallbackUserData);
         }
     }
-    else if (editor.SelectedNodeIndices.contains(node_idx))
+    else if (node.Selected)
     {
         mini_map_node_background = GImNodes->Style.Colors[ImNodesCol_MiniMapNodeBackgroundSelected];
     }
@@ -1832,14 +2732,6 @@ static void MiniMapDrawNode(ImNodesEditorContext& editor, const int node_idx)
 static void MiniMapDrawLink(ImNodesEditorContext& editor, const int link_idx)
 {
     const ImLinkData& link = editor.Links.Pool[link_idx];
-    const ImPinData&  start_pin = editor.Pins.Pool[link.StartPinIdx];
-    const ImPinData&  end_pin = editor.Pins.Pool[link.EndPinIdx];
-
-    const CubicBezier cubic_bezier = GetCubicBezier(
-        ScreenSpaceToMiniMapSpace(editor, start_pin.Pos),
-        ScreenSpaceToMiniMapSpace(editor, end_pin.Pos),
-        start_pin.Type,
-        GImNodes->Style.LinkLineSegmentsPerLength / editor.MiniMapScaling);
 
     // It's possible for a link to be deleted in begin_link_interaction. A user
     // may detach a link, resulting in the link wire snapping to the mouse
@@ -1853,21 +2745,25 @@ static void MiniMapDrawLink(ImNodesEditorContext& editor, const int link_idx)
 
     const ImU32 link_color =
         GImNodes->Style.Colors
-            [editor.SelectedLinkIndices.contains(link_idx) ? ImNodesCol_MiniMapLinkSelected
-                                                           : ImNodesCol_MiniMapLink];
+            [link.Selected ? ImNodesCol_MiniMapLinkSelected : ImNodesCol_MiniMapLink];
 
-#if IMGUI_VERSION_NUM < 18000
-    GImNodes->CanvasDrawList->AddBezierCurve(
+    ImVector<ImVec2>& points = GImNodes->LinkPolylineScreenSpace;
+    points.resize(link.GridSpacePolyline.size());
+    for (int i = 0; i < points.size(); ++i)
+    {
+        points[i] = GridSpaceToMiniMapSpace(editor, link.GridSpacePolyline[i]);
+    }
+
+    GImNodes->CanvasDrawList->AddPolyline(
+        points.Data,
+        points.Size,
+        link_color,
+#if IMGUI_VERSION_NUM < 18200
+        false,
 #else
-    GImNodes->CanvasDrawList->AddBezierCubic(
+        ImDrawFlags_None,
 #endif
-        cubic_bezier.P0,
-        cubic_bezier.P1,
-        cubic_bezier.P2,
-        cubic_bezier.P3,
-        link_color,
-        GImNodes->Style.LinkThickness * editor.MiniMapScaling,
-        cubic_bezier.NumSegments);
+        GImNodes->Style.LinkThickness * editor.MiniMapScaling);
 }
 
 static void MiniMapUpdate()
@@ -1955,31 +2851,226 @@ static void MiniMapUpdate()
 // [SECTION] selection helpers
 
 template<typename T>
-void SelectObject(const ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int id)
+void SelectObject(ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int id)
 {
     const int idx = ObjectPoolFind(objects, id);
     IM_ASSERT(idx >= 0);
-    IM_ASSERT(selected_indices.find(idx) == selected_indices.end());
-    selected_indices.push_back(idx);
+    SelectionAdd(objects, selected_indices, idx);
+}
+
+template<typename T>
+void ClearObjectSelection(ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int id)
+{
+    const int idx = ObjectPoolFind(objects, id);
+    IM_ASSERT(idx >= 0);
+    IM_ASSERT(objects.Pool[idx].Selected);
+    objects.Pool[idx].Selected = false;
+    selected_indices.find_erase_unsorted(idx);
+}
+
+template<typename T>
+bool IsObjectSelected(const ImObjectPool<T>& objects, const int id)
+{
+    const int idx = ObjectPoolFind(objects, id);
+    return idx >= 0 && objects.Pool[idx].Selected;
+}
+
+// Removes objects which are no longer in use from the selection, preserving the selection order.
+template<typename T>
+void RemoveUnusedObjectsFromSelection(
+    const ImObjectPool<T>& objects,
+    ImVector<int>&         selected_indices)
+{
+    int num_selected = 0;
+    for (int i = 0; i < selected_indices.size(); ++i)
+    {
+        if (objects.InUse[selected_indices[i]])
+        {
+            selected_indices[num_selected++] = selected_indices[i];
+        }
+    }
+    selected_indices.resize(num_selected);
+}
+
+// Resets the index if the object it refers to has been destroyed
+void ResetIndexIfUnused(ImOptionalIndex& idx, const ImVector<bool>& in_use)
+{
+    if (idx.HasValue() && !in_use[idx.Value()])
+    {
+        idx.Reset();
+    }
 }
 
-template<typename T>
-void ClearObjectSelection(
-    const ImObjectPool<T>& objects,
-    ImVector<int>&         selected_indices,
-    const int              id)
-{
-    const int idx = ObjectPoolFind(objects, id);
-    IM_ASSERT(idx >= 0);
-    IM_ASSERT(selected_indices.find(idx) != selected_indices.end());
-    selected_indices.find_erase_unsorted(idx);
+// Called after objects have been destroyed outside of a frame, so that neither the selection nor an
+// ongoing click interaction refers to their freed slots.
+void RemoveDestroyedObjectsFromEditorState(ImNodesEditorContext& editor)
+{
+    // The cached hovered objects may have been destroyed, and their slots may be reused
+    ++editor.SceneGeneration;
+    editor.HoverCache.Valid = false;
+    ResetIndexIfUnused(editor.LastHoveredNodeIdx, editor.Nodes.InUse);
+    ResetIndexIfUnused(editor.LastHoveredPinIdx, editor.Pins.InUse);
+    ResetIndexIfUnused(editor.LastHoveredLinkIdx, editor.Links.InUse);
+
+    // The ui state of the last frame refers to the current editor
+    if (&editor == GImNodes->EditorCtx)
+    {
+        ResetIndexIfUnused(GImNodes->HoveredNodeIdx, editor.Nodes.InUse);
+        ResetIndexIfUnused(GImNodes->HoveredPinIdx, editor.Pins.InUse);
+        ResetIndexIfUnused(GImNodes->HoveredLinkIdx, editor.Links.InUse);
+        ResetIndexIfUnused(GImNodes->DeletedLinkIdx, editor.Links.InUse);
+        ResetIndexIfUnused(GImNodes->SnapLinkIdx, editor.Links.InUse);
+    }
+
+    const int num_selected_nodes = editor.SelectedNodeIndices.size();
+    RemoveUnusedObjectsFromSelection(editor.Nodes, editor.SelectedNodeIndices);
+    RemoveUnusedObjectsFromSelection(editor.Links, editor.SelectedLinkIndices);
+
+    ImClickInteractionState& interaction = editor.ClickInteraction;
+    switch (interaction.Type)
+    {
+    case ImNodesClickInteractionType_Node:
+    {
+        // The offsets of the dragged nodes no longer match the selection
+        if (editor.SelectedNodeIndices.size() != num_selected_nodes)
+        {
+            interaction.Type = ImNodesClickInteractionType_None;
+        }
+    }
+    break;
+    case ImNodesClickInteractionType_LinkCreation:
+    {
+        if (!editor.Pins.InUse[interaction.LinkCreation.StartPinIdx])
+        {
+            interaction.Type = ImNodesClickInteractionType_None;
+        }
+        else if (
+            interaction.LinkCreation.EndPinIdx.HasValue() &&
+            !editor.Pins.InUse[interaction.LinkCreation.EndPinIdx.Value()])
+        {
+            interaction.LinkCreation.EndPinIdx.Reset();
+        }
+    }
+    break;
+    default:
+        break;
+    }
+}
+
+// Helpers for remapping indices after the object pools have been compacted. The new_indices map
+// each old index to the new index of the object.
+
+void RemapIndex(int& idx, const ImVector<int>& new_indices)
+{
+    idx = new_indices[idx];
+    IM_ASSERT(idx != -1);
+}
+
+void RemapIndex(ImOptionalIndex& idx, const ImVector<int>& new_indices)
+{
+    if (idx.HasValue())
+    {
+        idx = new_indices[idx.Value()];
+    }
+}
+
+void RemapIndices(ImVector<int>& indices, const ImVector<int>& new_indices)
+{
+    for (int i = 0; i < indices.size(); ++i)
+    {
+        RemapIndex(indices[i], new_indices);
+    }
+}
+
+// Reallocates the vector to hold exactly its elements
+template<typename T>
+void ShrinkToFit(ImVector<T>& vec)
+{
+    if (vec.Capacity == vec.Size)
+    {
+        return;
+    }
+
+    ImVector<T> packed;
+    packed.reserve(vec.Size);
+    packed.Size = vec.Size;
+    if (vec.Size > 0)
+    {
+        memcpy((void*)packed.Data, (const void*)vec.Data, vec.size_in_bytes());
+    }
+    vec.swap(packed);
+}
+
+// [SECTION] metrics
+
+// Draws the overlays enabled in ShowMetricsWindow() on top of the nodes and links, but below the
+// mini-map.
+void DrawMetricsOverlay(const ImNodesEditorContext& editor)
+{
+    ImDrawList* const draw_list = GImNodes->CanvasDrawList;
+
+    if (GImNodes->MetricsShowSpatialGridCells)
+    {
+        // The grid only stores the occupied cells, which are found via the nodes' cell ranges.
+        // Cells shared by several nodes are filled once per node, and appear more opaque.
+        const ImSpatialGrid& grid = editor.SpatialGrid;
+        const ImVec2         cell_size(grid.CellSize, grid.CellSize);
+        for (int node_idx = 0; node_idx < grid.NodeCellRanges.size(); ++node_idx)
+        {
+            const ImSpatialGrid::CellRange& range = grid.NodeCellRanges[node_idx];
+            for (int y = range.MinY; y <= range.MaxY; ++y)
+            {
+                for (int x = range.MinX; x <= range.MaxX; ++x)
+                {
+                    const ImVec2 cell_min = GridSpaceToScreenSpace(
+                        editor, ImVec2(x * grid.CellSize, y * grid.CellSize));
+                    const ImRect cell_rect(cell_min, cell_min + cell_size);
+                    if (GImNodes->CanvasRectScreenSpace.Overlaps(cell_rect))
+                    {
+                        draw_list->AddRectFilled(
+                            cell_rect.Min, cell_rect.Max, IM_COL32(255, 255, 0, 24));
+                        draw_list->AddRect(cell_rect.Min, cell_rect.Max, IM_COL32(255, 255, 0, 64));
+                    }
+                }
+            }
+        }
+    }
+
+    if (GImNodes->MetricsShowNodeRects)
+    {
+        for (int node_idx = 0; node_idx < editor.Nodes.Pool.size(); ++node_idx)
+        {
+            const ImNodeData& node = editor.Nodes.Pool[node_idx];
+            if (editor.Nodes.InUse[node_idx] && node.Submitted)
+            {
+                draw_list->AddRect(node.Rect.Min, node.Rect.Max, IM_COL32(255, 0, 255, 255));
+            }
+        }
+    }
+
+    if (GImNodes->MetricsShowLinkRects)
+    {
+        for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
+        {
+            if (editor.Links.InUse[link_idx])
+            {
+                const ImRect link_rect =
+                    GridSpaceToScreenSpace(editor, editor.Links.Pool[link_idx].GridSpaceBounds);
+                draw_list->AddRect(link_rect.Min, link_rect.Max, IM_COL32(0, 255, 255, 255));
+            }
+        }
+    }
 }
 
 template<typename T>
-bool IsObjectSelected(const ImObjectPool<T>& objects, ImVector<int>& selected_indices, const int id)
+void MetricsShowObjectPool(const char* const label, const ImObjectPool<T>& objects)
 {
-    const int idx = ObjectPoolFind(objects, id);
-    return selected_indices.find(idx) != selected_indices.end();
+    ImGui::Text(
+        "%s: %d slots, %d in use, %d free",
+        label,
+        objects.Pool.size(),
+        objects.NumInUse,
+        objects.FreeList.size());
 }
 
 } // namespace
@@ -1999,6 +3090,15 @@ ImNodesIO::ImNodesIO()
 {
 }
 
+ImNodesFrameStats::ImNodesFrameStats()
+    : NodesSubmitted(0), PinsSubmitted(0), LinksSubmitted(0), NodesDrawn(0), PinsDrawn(0),
+      LinksDrawn(0), NodesCulled(0), PinsCulled(0), LinksCulled(0), DrawChannels(0), Vertices(0),
+      Indices(0), NodePoolSize(0), PinPoolSize(0), LinkPoolSize(0), NodeFreeListSize(0),
+      PinFreeListSize(0), LinkFreeListSize(0), HoverResolutionTime(0.f), DrawTime(0.f),
+      DepthSortTime(0.f), ChannelsMergeTime(0.f), Allocations(-1)
+{
+}
+
 ImNodesStyle::ImNodesStyle()
     : GridSpacing(24.f), NodeCornerRounding(4.f), NodePadding(8.f, 8.f), NodeBorderThickness(1.f),
       LinkThickness(3.f), LinkLineSegmentsPerLength(0.1f), LinkHoverDistance(10.f),
@@ -2049,6 +3149,95 @@ void EditorContextFree(ImNodesEditorContext* ctx)
 
 void EditorContextSet(ImNodesEditorContext* ctx) { GImNodes->EditorCtx = ctx; }
 
+void EditorContextReserve(
+    ImNodesEditorContext* const editor_ptr,
+    const int                   num_nodes,
+    const int                   num_pins,
+    const int                   num_links)
+{
+    ImNodesEditorContext& editor = editor_ptr == NULL ? EditorContextGet() : *editor_ptr;
+
+    ObjectPoolReserve(editor.Nodes, num_nodes);
+    ObjectPoolReserve(editor.Pins, num_pins);
+    ObjectPoolReserve(editor.Links, num_links);
+    editor.NodeDepthOrder.Reserve(num_nodes);
+    editor.SpatialGrid.NodeCellRanges.reserve(num_nodes);
+}
+
+void EditorContextCompact(ImNodesEditorContext* const editor_ptr)
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+
+    ImNodesEditorContext& editor = editor_ptr == NULL ? EditorContextGet() : *editor_ptr;
+
+    ImVector<int> new_node_indices, new_pin_indices, new_link_indices;
+    ObjectPoolCompact(editor.Nodes, new_node_indices);
+    ObjectPoolCompact(editor.Pins, new_pin_indices);
+    ObjectPoolCompact(editor.Links, new_link_indices);
+
+    for (int node_idx = 0; node_idx < editor.Nodes.Pool.size(); ++node_idx)
+    {
+        ImVector<int>& pin_indices = editor.Nodes.Pool[node_idx].PinIndices;
+        RemapIndices(pin_indices, new_pin_indices);
+        ShrinkToFit(pin_indices);
+    }
+
+    for (int pin_idx = 0; pin_idx < editor.Pins.Pool.size(); ++pin_idx)
+    {
+        RemapIndex(editor.Pins.Pool[pin_idx].ParentNodeIdx, new_node_indices);
+    }
+
+    // The pairs of pins of the links are hashed again with the new indices
+    editor.PinLinks = ImPinLinkIndex();
+    for (int link_idx = 0; link_idx < editor.Links.Pool.size(); ++link_idx)
+    {
+        ImLinkData& link = editor.Links.Pool[link_idx];
+        RemapIndex(link.StartPinIdx, new_pin_indices);
+        RemapIndex(link.EndPinIdx, new_pin_indices);
+        editor.PinLinks.InsertLink(link_idx, link.StartPinIdx, link.EndPinIdx);
+    }
+
+    // The selection order and the offsets of the selected nodes are kept
+    RemapIndices(editor.SelectedNodeIndices, new_node_indices);
+    RemapIndices(editor.SelectedLinkIndices, new_link_indices);
+
+    {
+        ImNodeDepthOrder depth_order;
+        depth_order.Reserve(editor.Nodes.Pool.size());
+        for (int node_idx = editor.NodeDepthOrder.Bottom; node_idx != -1;
+             node_idx = editor.NodeDepthOrder.Next[node_idx])
+        {
+            depth_order.PushTop(new_node_indices[node_idx]);
+        }
+        editor.NodeDepthOrder = depth_order;
+    }
+
+    // The spatial indices are rebuilt when they are next needed
+    editor.SpatialGrid = ImSpatialGrid();
+    editor.LinkBvh = ImLinkBvh();
+    // The cached hovered objects refer to the old indices
+    ++editor.SceneGeneration;
+    RemapIndex(editor.LastHoveredNodeIdx, new_node_indices);
+    RemapIndex(editor.LastHoveredPinIdx, new_pin_indices);
+    RemapIndex(editor.LastHoveredLinkIdx, new_link_indices);
+
+    if (editor.ClickInteraction.Type == ImNodesClickInteractionType_LinkCreation)
+    {
+        RemapIndex(editor.ClickInteraction.LinkCreation.StartPinIdx, new_pin_indices);
+        RemapIndex(editor.ClickInteraction.LinkCreation.EndPinIdx, new_pin_indices);
+    }
+
+    // The ui state of the last frame refers to the current editor
+    if (&editor == GImNodes->EditorCtx)
+    {
+        RemapIndex(GImNodes->HoveredNodeIdx, new_node_indices);
+        RemapIndex(GImNodes->HoveredLinkIdx, new_link_indices);
+        RemapIndex(GImNodes->HoveredPinIdx, new_pin_indices);
+        RemapIndex(GImNodes->DeletedLinkIdx, new_link_indices);
+        RemapIndex(GImNodes->SnapLinkIdx, new_link_indices);
+    }
+}
+
 ImVec2 EditorContextGetPanning()
 {
     const ImNodesEditorContext& editor = EditorContextGet();
@@ -2064,7 +3253,7 @@ void EditorContextResetPanning(const ImVec2& pos)
 void EditorContextMoveToNode(const int node_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
 
     editor.Panning.x = -node.Origin.x;
     editor.Panning.y = -node.Origin.y;
@@ -2072,6 +3261,12 @@ void EditorContextMoveToNode(const int node_id)
 
 void SetImGuiContext(ImGuiContext* ctx) { ImGui::SetCurrentContext(ctx); }
 
+void EditorContextSetRetainedMode(const bool retained)
+{
+    ImNodesEditorContext& editor = EditorContextGet();
+    editor.RetainedMode = retained;
+}
+
 ImNodesIO& GetIO() { return GImNodes->Io; }
 
 ImNodesStyle& GetStyle() { return GImNodes->Style; }
@@ -2212,15 +3407,27 @@ void BeginNodeEditor()
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
     GImNodes->CurrentScope = ImNodesScope_Editor;
 
+    GImNodes->FrameAllocationCount = 0;
+    const AllocationCounterScope allocation_scope;
+
+    GImNodes->FrameStats = ImNodesFrameStats();
+
     // Reset state from previous pass
 
     ImNodesEditorContext& editor = EditorContextGet();
     editor.AutoPanningDelta = ImVec2(0, 0);
     editor.GridContentBounds = ImRect(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
     editor.MiniMapEnabled = false;
-    ObjectPoolReset(editor.Nodes);
-    ObjectPoolReset(editor.Pins);
-    ObjectPoolReset(editor.Links);
+    // In retained mode, objects stay alive until they are explicitly removed
+    if (!editor.RetainedMode)
+    {
+        ObjectPoolReset(editor.Nodes);
+        ObjectPoolReset(editor.Pins);
+        ObjectPoolReset(editor.Links);
+    }
+    ObjectPoolCollectStyles(editor.Nodes, editor.NodeStyles);
+    ObjectPoolCollectStyles(editor.Pins, editor.PinStyles);
+    ObjectPoolCollectStyles(editor.Links, editor.LinkStyles);
 
     GImNodes->HoveredNodeIdx.Reset();
     GImNodes->HoveredLinkIdx.Reset();
@@ -2228,8 +3435,6 @@ void BeginNodeEditor()
     GImNodes->DeletedLinkIdx.Reset();
     GImNodes->SnapLinkIdx.Reset();
 
-    GImNodes->NodeIndicesOverlappingWithMouse.clear();
-
     GImNodes->ImNodesUIState = ImNodesUIState_None;
 
     GImNodes->MousePos = ImGui::GetIO().MousePos;
@@ -2269,6 +3474,8 @@ void BeginNodeEditor()
         // BeginChild(), otherwise the ImGui UI elements are going to be
         // rendered into the parent window draw list.
         DrawListSet(ImGui::GetWindowDrawList());
+        GImNodes->CanvasVtxBufferStart = GImNodes->CanvasDrawList->VtxBuffer.Size;
+        GImNodes->CanvasIdxBufferStart = GImNodes->CanvasDrawList->IdxBuffer.Size;
 
         {
             const ImVec2 canvas_size = ImGui::GetWindowSize();
@@ -2288,7 +3495,15 @@ void EndNodeEditor()
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Editor);
     GImNodes->CurrentScope = ImNodesScope_None;
 
+    const AllocationCounterScope allocation_scope;
+
     ImNodesEditorContext& editor = EditorContextGet();
+    ImNodesFrameStats&    stats = GImNodes->FrameStats;
+
+    // All nodes have been laid out at this point, so the pin positions can be updated before they
+    // are used for hovering, rendering and interaction.
+    UpdateNodeGeometry(editor);
+    UpdateLinkGeometry(editor);
 
     bool no_grid_content = editor.GridContentBounds.IsInverted();
     if (no_grid_content)
@@ -2314,32 +3529,67 @@ void EndNodeEditor()
          editor.ClickInteraction.Type == ImNodesClickInteractionType_LinkCreation) &&
         MouseInCanvas() && !IsMiniMapHovered())
     {
-        // Pins needs some special care. We need to check the depth stack to see which pins are
-        // being occluded by other nodes.
-        ResolveOccludedPins(editor, GImNodes->OccludedPinIndices);
+        const FrameTimer hover_timer;
 
-        GImNodes->HoveredPinIdx = ResolveHoveredPin(editor.Pins, GImNodes->OccludedPinIndices);
-
-        if (!GImNodes->HoveredPinIdx.HasValue())
+        // Nothing the hovered objects depend on has changed since they were last resolved
+        if (HoverCacheIsValid(editor))
         {
-            // Resolve which node is actually on top and being hovered using the depth stack.
-            GImNodes->HoveredNodeIdx = ResolveHoveredNode(editor.NodeDepthOrder);
+            GImNodes->HoveredNodeIdx = editor.HoverCache.HoveredNodeIdx;
+            GImNodes->HoveredPinIdx = editor.HoverCache.HoveredPinIdx;
+            GImNodes->HoveredLinkIdx = editor.HoverCache.HoveredLinkIdx;
         }
-
-        // We don't check for hovered pins here, because if we want to detach a link by clicking and
-        // dragging, we need to have both a link and pin hovered.
-        if (!GImNodes->HoveredNodeIdx.HasValue())
+        else
         {
-            GImNodes->HoveredLinkIdx = ResolveHoveredLink(editor.Links, editor.Pins);
+            // Pins needs some special care. A pin within hover distance of the mouse may be
+            // occluded by a node above its own node in the depth order.
+            GImNodes->HoveredPinIdx = ResolveHoveredPin(editor);
+
+            if (!GImNodes->HoveredPinIdx.HasValue())
+            {
+                // Resolve which node is actually on top and being hovered using the depth stack.
+                GImNodes->HoveredNodeIdx = ResolveHoveredNode(editor);
+            }
+
+            // We don't check for hovered pins here, because if we want to detach a link by
+            // clicking and dragging, we need to have both a link and pin hovered.
+            if (!GImNodes->HoveredNodeIdx.HasValue())
+            {
+                // The links of a hovered pin are found with the pin link index
+                if (GImNodes->HoveredPinIdx.HasValue())
+                {
+                    PinLinkIndexUpdate(editor);
+                }
+                GImNodes->HoveredLinkIdx = ResolveHoveredLink(editor);
+            }
+
+            HoverCacheStore(editor);
         }
+
+        stats.HoverResolutionTime = hover_timer.Elapsed();
     }
 
+    const FrameTimer draw_timer;
+
     for (int node_idx = 0; node_idx < editor.Nodes.Pool.size(); ++node_idx)
     {
         if (editor.Nodes.InUse[node_idx])
         {
-            DrawListActivateNodeBackground(node_idx);
-            DrawNode(editor, node_idx);
+            const ImNodeData& node = editor.Nodes.Pool[node_idx];
+
+            // Nodes which weren't submitted this frame don't have any draw channels to render into
+            if (DrawListIsNodeSubmitted(node_idx) &&
+                GImNodes->CanvasRectScreenSpace.Overlaps(GetNodeDrawRect(node.Rect)))
+            {
+                DrawListActivateNodeBackground(node_idx);
+                DrawNode(editor, node_idx);
+                stats.NodesDrawn++;
+                stats.PinsDrawn += node.PinIndices.size();
+            }
+            else
+            {
+                stats.NodesCulled++;
+                stats.PinsCulled += node.PinIndices.size();
+            }
         }
     }
 
@@ -2355,12 +3605,22 @@ void EndNodeEditor()
         }
     }
 
+    stats.DrawTime = draw_timer.Elapsed();
+
+    // The state changed by the interactions below is only rendered in the next frame
+    const ImVec2 drawn_panning = editor.Panning;
+    const ImU32  drawn_scene_generation = editor.SceneGeneration;
+    const int    drawn_num_selected_nodes = editor.SelectedNodeIndices.size();
+    const int    drawn_num_selected_links = editor.SelectedLinkIndices.size();
+
     // Render the click interaction UI elements (partial links, box selector) on top of everything
     // else.
 
     DrawListAppendClickInteractionChannel();
     DrawListActivateClickInteractionChannel();
 
+    DrawMetricsOverlay(editor);
+
     if (IsMiniMapActive())
     {
         CalcMiniMapLayout();
@@ -2414,16 +3674,60 @@ void EndNodeEditor()
     // At this point, draw commands have been issued for all nodes (and pins). Update the node pool
     // to detect unused node slots and remove those indices from the depth stack before sorting the
     // node draw commands by depth.
-    ObjectPoolUpdate(editor.Nodes);
-    ObjectPoolUpdate(editor.Pins);
+    // The pools are only scanned when some of their objects weren't submitted.
+    const bool nodes_destroyed = NodePoolUpdate(editor);
+    const bool pins_destroyed = ObjectPoolUpdate(editor.Pins);
 
-    DrawListSortChannelsByDepth(editor.NodeDepthOrder);
+    {
+        const FrameTimer depth_sort_timer;
+        DrawListSortChannelsByDepth(editor.NodeDepthOrder);
+        stats.DepthSortTime = depth_sort_timer.Elapsed();
+    }
 
     // After the links have been rendered, the link pool can be updated as well.
-    ObjectPoolUpdate(editor.Links);
+    if (pins_destroyed)
+    {
+        FlagLinksToUnusedPinsAsUnused(editor);
+    }
+    const bool links_destroyed = LinkPoolUpdate(editor);
+    if (nodes_destroyed || pins_destroyed || links_destroyed)
+    {
+        ++editor.SceneGeneration;
+    }
+
+    if (nodes_destroyed)
+    {
+        RemoveUnusedObjectsFromSelection(editor.Nodes, editor.SelectedNodeIndices);
+    }
+    if (links_destroyed)
+    {
+        RemoveUnusedObjectsFromSelection(editor.Links, editor.SelectedLinkIndices);
+    }
+
+    editor.NeedsRedraw =
+        editor.ClickInteraction.Type != ImNodesClickInteractionType_None ||
+        editor.AutoPanningDelta.x != 0.f || editor.AutoPanningDelta.y != 0.f ||
+        editor.Panning.x != drawn_panning.x || editor.Panning.y != drawn_panning.y ||
+        editor.SceneGeneration != drawn_scene_generation ||
+        editor.SelectedNodeIndices.size() != drawn_num_selected_nodes ||
+        editor.SelectedLinkIndices.size() != drawn_num_selected_links ||
+        GImNodes->ImNodesUIState != ImNodesUIState_None ||
+        GImNodes->HoveredNodeIdx != editor.LastHoveredNodeIdx ||
+        GImNodes->HoveredPinIdx != editor.LastHoveredPinIdx ||
+        GImNodes->HoveredLinkIdx != editor.LastHoveredLinkIdx;
+    editor.LastHoveredNodeIdx = GImNodes->HoveredNodeIdx;
+    editor.LastHoveredPinIdx = GImNodes->HoveredPinIdx;
+    editor.LastHoveredLinkIdx = GImNodes->HoveredLinkIdx;
 
     // Finally, merge the draw channels
-    GImNodes->CanvasDrawList->ChannelsMerge();
+    {
+        stats.DrawChannels = GImNodes->CanvasDrawList->_Splitter._Count;
+        const FrameTimer channels_merge_timer;
+        GImNodes->CanvasDrawList->ChannelsMerge();
+        stats.ChannelsMergeTime = channels_merge_timer.Elapsed();
+    }
+    stats.Vertices = GImNodes->CanvasDrawList->VtxBuffer.Size - GImNodes->CanvasVtxBufferStart;
+    stats.Indices = GImNodes->CanvasDrawList->IdxBuffer.Size - GImNodes->CanvasIdxBufferStart;
 
     // pop style
     ImGui::EndChild();      // end scrolling region
@@ -2431,6 +3735,18 @@ void EndNodeEditor()
     ImGui::PopStyleVar();   // pop window padding
     ImGui::PopStyleVar();   // pop frame padding
     ImGui::EndGroup();
+
+    stats.NodePoolSize = editor.Nodes.Pool.size();
+    stats.PinPoolSize = editor.Pins.Pool.size();
+    stats.LinkPoolSize = editor.Links.Pool.size();
+    stats.NodeFreeListSize = editor.Nodes.FreeList.size();
+    stats.PinFreeListSize = editor.Pins.FreeList.size();
+    stats.LinkFreeListSize = editor.Links.FreeList.size();
+    if (GImNodes->AllocationCounterEnabled)
+    {
+        stats.Allocations = GImNodes->FrameAllocationCount;
+    }
+    editor.FrameStats = stats;
 }
 
 void MiniMap(
@@ -2467,27 +3783,44 @@ void BeginNode(const int node_id)
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Editor);
     GImNodes->CurrentScope = ImNodesScope_Node;
 
+    const AllocationCounterScope allocation_scope;
+
     ImNodesEditorContext& editor = EditorContextGet();
 
-    const int node_idx = ObjectPoolFindOrCreateIndex(editor.Nodes, node_id);
+    const int node_idx = NodePoolFindOrCreateIndex(editor, node_id);
     GImNodes->CurrentNodeIdx = node_idx;
+    GImNodes->FrameStats.NodesSubmitted++;
 
     ImNodeData& node = editor.Nodes.Pool[node_idx];
-    node.ColorStyle.Background = GImNodes->Style.Colors[ImNodesCol_NodeBackground];
-    node.ColorStyle.BackgroundHovered = GImNodes->Style.Colors[ImNodesCol_NodeBackgroundHovered];
-    node.ColorStyle.BackgroundSelected = GImNodes->Style.Colors[ImNodesCol_NodeBackgroundSelected];
-    node.ColorStyle.Outline = GImNodes->Style.Colors[ImNodesCol_NodeOutline];
-    node.ColorStyle.Titlebar = GImNodes->Style.Colors[ImNodesCol_TitleBar];
-    node.ColorStyle.TitlebarHovered = GImNodes->Style.Colors[ImNodesCol_TitleBarHovered];
-    node.ColorStyle.TitlebarSelected = GImNodes->Style.Colors[ImNodesCol_TitleBarSelected];
-    node.LayoutStyle.CornerRounding = GImNodes->Style.NodeCornerRounding;
-    node.LayoutStyle.Padding = GImNodes->Style.NodePadding;
-    node.LayoutStyle.BorderThickness = GImNodes->Style.NodeBorderThickness;
+    // The node's pins are flagged as used again as they are submitted. Pins which are no longer
+    // submitted as part of the node are destroyed at the end of the frame.
+    for (int i = 0; i < node.PinIndices.size(); ++i)
+    {
+        ObjectPoolSetInUse(editor.Pins, node.PinIndices[i], false);
+    }
+    // The memory is kept for the pins submitted below
+    node.PinIndices.resize(0);
+    // Nodes submitted with the same style share a palette entry, so the style is only copied
+    // when it changes
+    ImNodeStyleData node_style;
+    node_style.ColorStyle.Background = GImNodes->Style.Colors[ImNodesCol_NodeBackground];
+    node_style.ColorStyle.BackgroundHovered =
+        GImNodes->Style.Colors[ImNodesCol_NodeBackgroundHovered];
+    node_style.ColorStyle.BackgroundSelected =
+        GImNodes->Style.Colors[ImNodesCol_NodeBackgroundSelected];
+    node_style.ColorStyle.Outline = GImNodes->Style.Colors[ImNodesCol_NodeOutline];
+    node_style.ColorStyle.Titlebar = GImNodes->Style.Colors[ImNodesCol_TitleBar];
+    node_style.ColorStyle.TitlebarHovered = GImNodes->Style.Colors[ImNodesCol_TitleBarHovered];
+    node_style.ColorStyle.TitlebarSelected = GImNodes->Style.Colors[ImNodesCol_TitleBarSelected];
+    node_style.LayoutStyle.CornerRounding = GImNodes->Style.NodeCornerRounding;
+    node_style.LayoutStyle.Padding = GImNodes->Style.NodePadding;
+    node_style.LayoutStyle.BorderThickness = GImNodes->Style.NodeBorderThickness;
+    editor.Nodes.Cold[node_idx].StyleIdx = editor.NodeStyles.Intern(node_style);
 
     // ImGui::SetCursorPos sets the cursor position, local to the current widget
     // (in this case, the child object started in BeginNodeEditor). Use
     // ImGui::SetCursorScreenPos to set the screen space coordinates directly.
-    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeTitleBarOrigin(node)));
+    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeTitleBarOrigin(node, node_style)));
 
     DrawListAddNode(node_idx);
     DrawListActivateCurrentNodeForeground();
@@ -2501,23 +3834,61 @@ void EndNode()
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Node);
     GImNodes->CurrentScope = ImNodesScope_Editor;
 
+    const AllocationCounterScope allocation_scope;
+
     ImNodesEditorContext& editor = EditorContextGet();
 
     // The node's rectangle depends on the ImGui UI group size.
     ImGui::EndGroup();
     ImGui::PopID();
 
-    ImNodeData& node = editor.Nodes.Pool[GImNodes->CurrentNodeIdx];
-    node.Rect = GetItemRect();
-    node.Rect.Expand(node.LayoutStyle.Padding);
+    ImNodeData&           node = editor.Nodes.Pool[GImNodes->CurrentNodeIdx];
+    const ImNodeColdData& node_cold = editor.Nodes.Cold[GImNodes->CurrentNodeIdx];
+    ImRect                node_rect = GetItemRect();
+    node_rect.Expand(editor.NodeStyles.Styles[node_cold.StyleIdx].LayoutStyle.Padding);
+    if (memcmp(&node_rect, &node.Rect, sizeof(ImRect)) != 0)
+    {
+        node.Rect = node_rect;
+        ++editor.SceneGeneration;
+    }
 
     editor.GridContentBounds.Add(node.Origin);
     editor.GridContentBounds.Add(node.Origin + node.Rect.GetSize());
+}
+
+bool IsNodeVisible(const int node_id)
+{
+    // Call this function between BeginNodeEditor() and EndNodeEditor(), but outside of a node
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Editor);
+
+    const AllocationCounterScope allocation_scope;
+
+    ImNodesEditorContext& editor = EditorContextGet();
+    const int             node_idx = ObjectPoolFind(editor.Nodes, node_id);
 
-    if (node.Rect.Contains(GImNodes->MousePos))
+    // The size of a node is unknown until it has been submitted at least once
+    if (node_idx == -1 || editor.Nodes.Pool[node_idx].Rect.GetArea() <= 0.f)
     {
-        GImNodes->NodeIndicesOverlappingWithMouse.push_back(GImNodes->CurrentNodeIdx);
+        return true;
+    }
+
+    const ImNodeData& node = editor.Nodes.Pool[node_idx];
+    const ImVec2      node_screen_pos = GridSpaceToScreenSpace(editor, node.Origin);
+    const ImRect      node_rect(node_screen_pos, node_screen_pos + node.Rect.GetSize());
+
+    if (GImNodes->CanvasRectScreenSpace.Overlaps(GetNodeDrawRect(node_rect)))
+    {
+        return true;
+    }
+
+    // Keep the node and its pins alive for this frame, even though the node won't be submitted
+    ObjectPoolSetInUse(editor.Nodes, node_idx, true);
+    for (int i = 0; i < node.PinIndices.size(); ++i)
+    {
+        ObjectPoolSetInUse(editor.Pins, node.PinIndices[i], true);
     }
+
+    return false;
 }
 
 ImVec2 GetNodeDimensions(int node_id)
@@ -2540,13 +3911,16 @@ void EndNodeTitleBar()
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Node);
     ImGui::EndGroup();
 
-    ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = editor.Nodes.Pool[GImNodes->CurrentNodeIdx];
-    node.TitleBarContentRect = GetItemRect();
+    ImNodesEditorContext&  editor = EditorContextGet();
+    ImNodeData&            node = editor.Nodes.Pool[GImNodes->CurrentNodeIdx];
+    ImNodeColdData&        node_cold = editor.Nodes.Cold[GImNodes->CurrentNodeIdx];
+    const ImNodeStyleData& node_style = editor.NodeStyles.Styles[node_cold.StyleIdx];
+    node_cold.TitleBarContentRect = GetItemRect();
 
-    ImGui::ItemAdd(GetNodeTitleRect(node), ImGui::GetID("title_bar"));
+    ImGui::ItemAdd(GetNodeTitleRect(node, node_cold, node_style), ImGui::GetID("title_bar"));
 
-    ImGui::SetCursorPos(GridSpaceToEditorSpace(editor, GetNodeContentOrigin(node)));
+    ImGui::SetCursorPos(
+        GridSpaceToEditorSpace(editor, GetNodeContentOrigin(node, node_cold, node_style)));
 }
 
 void BeginInputAttribute(const int id, const ImNodesPinShape shape)
@@ -2611,18 +3985,38 @@ void Link(const int id, const int start_attr_id, const int end_attr_id)
 {
     IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_Editor);
 
+    const AllocationCounterScope allocation_scope;
+
     ImNodesEditorContext& editor = EditorContextGet();
-    ImLinkData&           link = ObjectPoolFindOrCreateObject(editor.Links, id);
+    const int             link_idx = ObjectPoolFindOrCreateIndex(editor.Links, id);
+    ImLinkData&           link = editor.Links.Pool[link_idx];
     link.Id = id;
-    link.StartPinIdx = ObjectPoolFindOrCreateIndex(editor.Pins, start_attr_id);
-    link.EndPinIdx = ObjectPoolFindOrCreateIndex(editor.Pins, end_attr_id);
-    link.ColorStyle.Base = GImNodes->Style.Colors[ImNodesCol_Link];
-    link.ColorStyle.Hovered = GImNodes->Style.Colors[ImNodesCol_LinkHovered];
-    link.ColorStyle.Selected = GImNodes->Style.Colors[ImNodesCol_LinkSelected];
+    GImNodes->FrameStats.LinksSubmitted++;
+
+    const int start_pin_idx = ObjectPoolFindOrCreateIndex(editor.Pins, start_attr_id);
+    const int end_pin_idx = ObjectPoolFindOrCreateIndex(editor.Pins, end_attr_id);
+    if (link.StartPinIdx != start_pin_idx || link.EndPinIdx != end_pin_idx)
+    {
+        if (link.StartPinIdx != -1)
+        {
+            editor.PinLinks.RemoveLink(link_idx, link.StartPinIdx, link.EndPinIdx);
+        }
+        editor.PinLinks.InsertLink(link_idx, start_pin_idx, end_pin_idx);
+        link.StartPinIdx = start_pin_idx;
+        link.EndPinIdx = end_pin_idx;
+        editor.PinLinks.Dirty = true;
+        ++editor.SceneGeneration;
+    }
+
+    ImLinkStyleData link_style;
+    link_style.ColorStyle.Base = GImNodes->Style.Colors[ImNodesCol_Link];
+    link_style.ColorStyle.Hovered = GImNodes->Style.Colors[ImNodesCol_LinkHovered];
+    link_style.ColorStyle.Selected = GImNodes->Style.Colors[ImNodesCol_LinkSelected];
+    editor.Links.Cold[link_idx].StyleIdx = editor.LinkStyles.Intern(link_style);
 
     // Check if this link was created by the current link event
     if ((editor.ClickInteraction.Type == ImNodesClickInteractionType_LinkCreation &&
-         editor.Pins.Pool[link.EndPinIdx].Flags & ImNodesAttributeFlags_EnableLinkCreationOnSnap &&
+         editor.Pins.Cold[link.EndPinIdx].Flags & ImNodesAttributeFlags_EnableLinkCreationOnSnap &&
          editor.ClickInteraction.LinkCreation.StartPinIdx == link.StartPinIdx &&
          editor.ClickInteraction.LinkCreation.EndPinIdx == link.EndPinIdx) ||
         (editor.ClickInteraction.LinkCreation.StartPinIdx == link.EndPinIdx &&
@@ -2745,28 +4139,56 @@ void PopStyleVar(int count)
 void SetNodeScreenSpacePos(const int node_id, const ImVec2& screen_space_pos)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
     node.Origin = ScreenSpaceToGridSpace(editor, screen_space_pos);
 }
 
 void SetNodeEditorSpacePos(const int node_id, const ImVec2& editor_space_pos)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
     node.Origin = EditorSpaceToGridSpace(editor, editor_space_pos);
 }
 
 void SetNodeGridSpacePos(const int node_id, const ImVec2& grid_pos)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
     node.Origin = grid_pos;
 }
 
+void SetNodeGridSpacePositions(
+    const int* const    node_ids,
+    const ImVec2* const grid_positions,
+    const int           count)
+{
+    ImNodesEditorContext& editor = EditorContextGet();
+
+    // Make room for all of the new nodes at once
+    int num_new_nodes = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        num_new_nodes += ObjectPoolFind(editor.Nodes, node_ids[i]) == -1 ? 1 : 0;
+    }
+
+    if (num_new_nodes > 0)
+    {
+        const int capacity = editor.Nodes.Pool.size() + num_new_nodes;
+        ObjectPoolReserve(editor.Nodes, capacity);
+        editor.NodeDepthOrder.Reserve(capacity);
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        ImNodeData& node = NodePoolFindOrCreateObject(editor, node_ids[i]);
+        node.Origin = grid_positions[i];
+    }
+}
+
 void SetNodeDraggable(const int node_id, const bool draggable)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
     node.Draggable = draggable;
 }
 
@@ -2800,10 +4222,57 @@ ImVec2 GetNodeGridSpacePos(const int node_id)
 void SnapNodeToGrid(int node_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    ImNodeData&           node = ObjectPoolFindOrCreateObject(editor.Nodes, node_id);
+    ImNodeData&           node = NodePoolFindOrCreateObject(editor, node_id);
     node.Origin = SnapOriginToGrid(node.Origin);
 }
 
+void RemoveNode(const int node_id) { RemoveNodes(&node_id, 1); }
+
+void RemoveNodes(const int* const node_ids, const int count)
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+
+    ImNodesEditorContext& editor = EditorContextGet();
+    bool                  pins_destroyed = false;
+    for (int i = 0; i < count; ++i)
+    {
+        const int node_idx = ObjectPoolFind(editor.Nodes, node_ids[i]);
+        IM_ASSERT(node_idx != -1); // invalid node_id
+
+        const ImNodeData& node = editor.Nodes.Pool[node_idx];
+        for (int j = 0; j < node.PinIndices.size(); ++j)
+        {
+            ObjectPoolDestroy(editor.Pins, node.PinIndices[j]);
+        }
+        pins_destroyed |= !node.PinIndices.empty();
+
+        editor.NodeDepthOrder.Remove(node_idx);
+        ObjectPoolDestroy(editor.Nodes, node_idx);
+    }
+
+    // Outside of a frame, every live object is in use. The links attached to the destroyed pins are
+    // the only links flagged as unused here, and are destroyed in a single pass over the links.
+    if (pins_destroyed)
+    {
+        FlagLinksToUnusedPinsAsUnused(editor);
+        LinkPoolUpdate(editor);
+    }
+
+    RemoveDestroyedObjectsFromEditorState(editor);
+}
+
+void RemoveLink(const int link_id)
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+
+    ImNodesEditorContext& editor = EditorContextGet();
+    const int             link_idx = ObjectPoolFind(editor.Links, link_id);
+    IM_ASSERT(link_idx != -1); // invalid link_id
+
+    LinkPoolDestroy(editor, link_idx);
+    RemoveDestroyedObjectsFromEditorState(editor);
+}
+
 bool IsEditorHovered() { return MouseInCanvas(); }
 
 bool IsNodeHovered(int* const node_id)
@@ -2889,7 +4358,7 @@ void GetSelectedLinks(int* link_ids)
 void ClearNodeSelection()
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    editor.SelectedNodeIndices.clear();
+    SelectionClear(editor.Nodes, editor.SelectedNodeIndices);
 }
 
 void ClearNodeSelection(int node_id)
@@ -2901,7 +4370,7 @@ void ClearNodeSelection(int node_id)
 void ClearLinkSelection()
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    editor.SelectedLinkIndices.clear();
+    SelectionClear(editor.Links, editor.SelectedLinkIndices);
 }
 
 void ClearLinkSelection(int link_id)
@@ -2925,13 +4394,49 @@ void SelectLink(int link_id)
 bool IsNodeSelected(int node_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    return IsObjectSelected(editor.Nodes, editor.SelectedNodeIndices, node_id);
+    return IsObjectSelected(editor.Nodes, node_id);
 }
 
 bool IsLinkSelected(int link_id)
 {
     ImNodesEditorContext& editor = EditorContextGet();
-    return IsObjectSelected(editor.Links, editor.SelectedLinkIndices, link_id);
+    return IsObjectSelected(editor.Links, link_id);
+}
+
+int NumLinksForPin(const int pin_id)
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+    ImNodesEditorContext& editor = EditorContextGet();
+    const int             pin_idx = ObjectPoolFind(editor.Pins, pin_id);
+    if (pin_idx == -1)
+    {
+        return 0;
+    }
+
+    PinLinkIndexUpdate(editor);
+    int first;
+    return PinLinkIndexGetLinks(editor.PinLinks, pin_idx, &first);
+}
+
+void GetLinksForPin(const int pin_id, int* const link_ids)
+{
+    IM_ASSERT(GImNodes->CurrentScope == ImNodesScope_None);
+    IM_ASSERT(link_ids != NULL);
+    ImNodesEditorContext& editor = EditorContextGet();
+    const int             pin_idx = ObjectPoolFind(editor.Pins, pin_id);
+    if (pin_idx == -1)
+    {
+        return;
+    }
+
+    PinLinkIndexUpdate(editor);
+    int       first;
+    const int num_links = PinLinkIndexGetLinks(editor.PinLinks, pin_idx, &first);
+    for (int i = 0; i < num_links; ++i)
+    {
+        const int link_idx = editor.PinLinks.LinkIndices[first + i];
+        link_ids[i] = editor.Links.Pool[link_idx].Id;
+    }
 }
 
 bool IsAttributeActive()
@@ -3106,6 +4611,120 @@ bool IsLinkDestroyed(int* const link_id)
     return link_destroyed;
 }
 
+bool EditorNeedsRedraw()
+{
+    const ImNodesEditorContext& editor = EditorContextGet();
+    return editor.NeedsRedraw;
+}
+
+void SetAllocationCounterEnabled(const bool enabled)
+{
+    AllocationCounterSetEnabled(*GImNodes, enabled);
+}
+
+void GetFrameStats(ImNodesFrameStats* const stats)
+{
+    IM_ASSERT(stats != NULL);
+    const ImNodesEditorContext& editor = EditorContextGet();
+    *stats = editor.FrameStats;
+}
+
+void ShowMetricsWindow(bool* const p_open)
+{
+    if (!ImGui::Begin("ImNodes Metrics", p_open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const ImNodesEditorContext& editor = EditorContextGet();
+    const ImNodesFrameStats&    stats = editor.FrameStats;
+
+    ImGui::Text(
+        "Nodes: %d submitted, %d drawn, %d culled",
+        stats.NodesSubmitted,
+        stats.NodesDrawn,
+        stats.NodesCulled);
+    ImGui::Text(
+        "Pins: %d submitted, %d drawn, %d culled",
+        stats.PinsSubmitted,
+        stats.PinsDrawn,
+        stats.PinsCulled);
+    ImGui::Text(
+        "Links: %d submitted, %d drawn, %d culled",
+        stats.LinksSubmitted,
+        stats.LinksDrawn,
+        stats.LinksCulled);
+    ImGui::Text(
+        "Draw channels: %d, vertices: %d, indices: %d",
+        stats.DrawChannels,
+        stats.Vertices,
+        stats.Indices);
+
+#if IMGUI_VERSION_NUM >= 18300
+    bool allocation_counter_enabled = GImNodes->AllocationCounterEnabled;
+    if (ImGui::Checkbox("Count allocations", &allocation_counter_enabled))
+    {
+        SetAllocationCounterEnabled(allocation_counter_enabled);
+    }
+#endif
+    if (stats.Allocations >= 0)
+    {
+        ImGui::Text("Allocations: %d", stats.Allocations);
+    }
+    else
+    {
+        ImGui::TextDisabled("Allocations: counter disabled");
+    }
+
+    if (ImGui::TreeNode("Timings"))
+    {
+        ImGui::Text("Hover resolution: %.3f ms", stats.HoverResolutionTime);
+        ImGui::Text("Drawing: %.3f ms", stats.DrawTime);
+        ImGui::Text("Depth sort: %.3f ms", stats.DepthSortTime);
+        ImGui::Text("Channels merge: %.3f ms", stats.ChannelsMergeTime);
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("Pools"))
+    {
+        MetricsShowObjectPool("Nodes", editor.Nodes);
+        MetricsShowObjectPool("Pins", editor.Pins);
+        MetricsShowObjectPool("Links", editor.Links);
+        ImGui::TreePop();
+    }
+
+    ImGui::Text(
+        "Selection: %d nodes, %d links",
+        editor.SelectedNodeIndices.size(),
+        editor.SelectedLinkIndices.size());
+
+    if (ImGui::TreeNode("DepthStack", "Depth stack (%d nodes)", editor.NodeDepthOrder.Size))
+    {
+        // From the top-most node down
+        for (int node_idx = editor.NodeDepthOrder.Top; node_idx != -1;
+             node_idx = editor.NodeDepthOrder.Prev[node_idx])
+        {
+            ImGui::Text(
+                "Node %d (index %d, rank %d)",
+                editor.Nodes.Pool[node_idx].Id,
+                node_idx,
+                editor.NodeDepthOrder.Rank[node_idx]);
+        }
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("Overlays"))
+    {
+        ImGui::Checkbox("Show node rectangles", &GImNodes->MetricsShowNodeRects);
+        ImGui::Checkbox("Show link bounds", &GImNodes->MetricsShowLinkRects);
+        ImGui::Checkbox("Show spatial grid cells", &GImNodes->MetricsShowSpatialGridCells);
+        ImGui::TreePop();
+    }
+
+    ImGui::End();
+}
+
 namespace
 {
 void NodeLineHandler(ImNodesEditorContext& editor, const char* const line)
@@ -3114,7 +4733,7 @@ void NodeLineHandler(ImNodesEditorContext& editor, const char* const line)
     int x, y;
     if (sscanf(line, "[node.%i", &id) == 1)
     {
-        const int node_idx = ObjectPoolFindOrCreateIndex(editor.Nodes, id);
+        const int node_idx = NodePoolFindOrCreateIndex(editor, id);
         GImNodes->CurrentNodeIdx = node_idx;
         ImNodeData& node = editor.Nodes.Pool[node_idx];
         node.Id = id;
@@ -3191,6 +4810,18 @@ void LoadEditorStateFromIniString(
     memcpy(buf, data, data_size);
     buf[data_size] = 0;
 
+    // Make room for the saved nodes before creating them
+    int num_nodes = 0;
+    for (const char* node_section = strstr(buf, "[node."); node_section != NULL;
+         node_section = strstr(node_section + 1, "[node."))
+    {
+        ++num_nodes;
+    }
+    if (num_nodes > 0)
+    {
+        EditorContextReserve(&editor, editor.Nodes.Pool.size() + num_nodes, 0, 0);
+    }
+
     void (*line_handler)(ImNodesEditorContext&, const char*);
     line_handler = NULL;
     char* line_end = NULL;
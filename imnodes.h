@@ -78,7 +78,11 @@ enum ImNodesStyleFlags_
     ImNodesStyleFlags_NodeOutline = 1 << 0,
     ImNodesStyleFlags_GridLines = 1 << 2,
     ImNodesStyleFlags_GridLinesPrimary = 1 << 3,
-    ImNodesStyleFlags_GridSnapping = 1 << 4
+    ImNodesStyleFlags_GridSnapping = 1 << 4,
+    // Render all nodes into one shared draw channel instead of two draw channels per node. The
+    // draw commands of each node are reordered by depth when the node editor ends. This reduces
+    // draw list memory use and the number of draw commands for large graphs.
+    ImNodesStyleFlags_SingleNodeDrawChannel = 1 << 5
 };
 
 enum ImNodesPinShape_
@@ -208,6 +212,56 @@ struct ImNodesStyle
     ImNodesStyle();
 };
 
+// Statistics gathered by the current editor during the last EndNodeEditor() call.
+struct ImNodesFrameStats
+{
+    // The number of nodes, pins and links which were submitted during the frame. In retained mode,
+    // objects which weren't submitted are still alive, but aren't rendered.
+    int NodesSubmitted;
+    int PinsSubmitted;
+    int LinksSubmitted;
+
+    // The number of nodes, pins and links which were rendered.
+    int NodesDrawn;
+    int PinsDrawn;
+    int LinksDrawn;
+
+    // The number of nodes, pins and links which were not rendered, because they were entirely
+    // outside of the visible canvas area, or weren't submitted in retained mode.
+    int NodesCulled;
+    int PinsCulled;
+    int LinksCulled;
+
+    // The number of draw channels which the canvas draw list was split into, and the number of
+    // vertices and indices which were added to the canvas draw list. The latter include the
+    // vertices and indices emitted by the UI code of the nodes.
+    int DrawChannels;
+    int Vertices;
+    int Indices;
+
+    // The number of slots in the node, pin and link pools, and how many of them are free for reuse.
+    int NodePoolSize;
+    int PinPoolSize;
+    int LinkPoolSize;
+    int NodeFreeListSize;
+    int PinFreeListSize;
+    int LinkFreeListSize;
+
+    // Time spent in the individual phases of EndNodeEditor(), in milliseconds: resolving the
+    // hovered node, pin and link, drawing the nodes and links, sorting the draw channels by depth,
+    // and merging the draw channels.
+    float HoverResolutionTime;
+    float DrawTime;
+    float DepthSortTime;
+    float ChannelsMergeTime;
+
+    // The number of heap allocations made by imnodes during the frame, or -1 if the allocation
+    // counter is disabled. See SetAllocationCounterEnabled().
+    int Allocations;
+
+    ImNodesFrameStats();
+};
+
 enum ImNodesMiniMapLocation_
 {
     ImNodesMiniMapLocation_BottomLeft,
@@ -254,6 +308,17 @@ void                  EditorContextSet(ImNodesEditorContext*);
 ImVec2                EditorContextGetPanning();
 void                  EditorContextResetPanning(const ImVec2& pos);
 void                  EditorContextMoveToNode(const int node_id);
+// In retained mode, the nodes, pins and links of the current editor stay alive when they are not
+// submitted during a frame, until they are explicitly removed with RemoveNode() or RemoveLink().
+// Only the nodes which should be rendered need to be submitted each frame. Disabled by default.
+void EditorContextSetRetainedMode(bool retained);
+// Make room for the given total number of nodes, pins and links in the editor, before creating a
+// large graph. NULL = the current editor.
+void EditorContextReserve(ImNodesEditorContext*, int num_nodes, int num_pins, int num_links);
+// Release the memory held by the editor's removed nodes, pins and links, e.g. after removing a
+// large part of the graph. Call this outside of BeginNodeEditor()/EndNodeEditor(). NULL = the
+// current editor.
+void EditorContextCompact(ImNodesEditorContext*);
 
 ImNodesIO& GetIO();
 
@@ -291,6 +356,13 @@ void EndNode();
 
 ImVec2 GetNodeDimensions(int id);
 
+// Returns true if the node will be visible on the canvas this frame. Call this before the node's
+// BeginNode() call, and skip submitting the node altogether if it returns false. A node which is
+// not visible is kept alive for the current frame, so its position, selection state and pins are
+// retained. The check uses the node's size from its last submission, and returns true for nodes
+// which haven't been submitted yet.
+bool IsNodeVisible(int node_id);
+
 // Place your node title bar content (such as the node title, using ImGui::Text) between the
 // following function calls. These functions have to be called before adding any attributes, or the
 // layout of the node will be incorrect.
@@ -342,6 +414,9 @@ void SetNodeDraggable(int node_id, const bool draggable);
 void SetNodeScreenSpacePos(int node_id, const ImVec2& screen_space_pos);
 void SetNodeEditorSpacePos(int node_id, const ImVec2& editor_space_pos);
 void SetNodeGridSpacePos(int node_id, const ImVec2& grid_pos);
+// Set the grid space positions of many nodes at once. This is faster than calling
+// SetNodeGridSpacePos() for each node, when many of the nodes are being created.
+void SetNodeGridSpacePositions(const int* node_ids, const ImVec2* grid_positions, int count);
 
 ImVec2 GetNodeScreenSpacePos(const int node_id);
 ImVec2 GetNodeEditorSpacePos(const int node_id);
@@ -350,6 +425,15 @@ ImVec2 GetNodeGridSpacePos(const int node_id);
 // If ImNodesStyleFlags_GridSnapping is enabled, snap the specified node's origin to the grid.
 void SnapNodeToGrid(int node_id);
 
+// Remove a node along with its pins and the links attached to them, or a single link. These are
+// mainly useful in retained mode; in immediate mode, an object is removed by no longer submitting
+// it. Call these outside of BeginNodeEditor()/EndNodeEditor(). The objects are destroyed
+// immediately, and their ids may be reused right away. Removing many nodes with RemoveNodes() is
+// cheaper than removing them one at a time, as the links are only searched once.
+void RemoveNode(int node_id);
+void RemoveNodes(const int* node_ids, int count);
+void RemoveLink(int link_id);
+
 // Returns true if the current node editor canvas is being hovered over by the mouse, and is not
 // blocked by any other windows.
 bool IsEditorHovered();
@@ -385,6 +469,14 @@ void SelectLink(int link_id);
 void ClearLinkSelection(int link_id);
 bool IsLinkSelected(int link_id);
 
+// Use the following two functions to query the links connected to a pin in the current editor. The
+// pointer argument of GetLinksForPin should point to an integer array with at least as many
+// elements as NumLinksForPin returned. The link ids are in no particular order, e.g. they aren't
+// sorted by id, and their order may change when links are created or destroyed. Use after calling
+// EndNodeEditor().
+int NumLinksForPin(int pin_id);
+void GetLinksForPin(int pin_id, int* link_ids);
+
 // Was the previous attribute active? This will continuously return true while the left mouse button
 // is being pressed over the UI content of the attribute.
 bool IsAttributeActive();
@@ -419,6 +511,29 @@ bool IsLinkCreated(
 // output argument link_id.
 bool IsLinkDestroyed(int* link_id);
 
+// Returns true if the current editor would be rendered differently in the next frame even if the
+// input stays the same, e.g. while auto-panning, during a click interaction such as dragging a node
+// or the mini-map, or after the hovered objects changed. Use after EndNodeEditor(). When this is
+// false for every editor, and nothing else in the UI is changing, the application can wait for
+// input events before rendering the next frame.
+bool EditorNeedsRedraw();
+
+// Copies the statistics of the current editor's last EndNodeEditor() call to the output argument.
+void GetFrameStats(ImNodesFrameStats* stats);
+// Count the heap allocations made by imnodes between BeginNodeEditor() and EndNodeEditor(), and
+// report them in ImNodesFrameStats::Allocations. Once the editor's buffers have grown to fit the
+// graph, a frame in which the graph doesn't change shouldn't allocate. The setting is per context,
+// but the counter wraps the process-wide allocator functions of ImGui while any context has it
+// enabled, so enable it after calling ImGui::SetAllocatorFunctions(), if at all. This is a
+// debugging aid, and requires Dear ImGui 1.83 or newer. Disabled by default.
+void SetAllocationCounterEnabled(bool enabled);
+
+// Shows a window with the frame statistics and the internal state of the current editor, e.g. the
+// object pools, the depth order and the selection, similar to ImGui::ShowMetricsWindow(). The
+// window can also overlay the node rectangles, link bounds and occupied spatial grid cells on the
+// canvas, which are drawn by the next EndNodeEditor() call.
+void ShowMetricsWindow(bool* p_open = NULL);
+
 // Use the following functions to write the editor context's state to a string, or directly to a
 // file. The editor context is serialized in the INI file format.
 
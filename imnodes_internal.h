@@ -69,23 +69,192 @@ enum ImNodesLinkCreationType_
 
 // [SECTION] internal data structures
 
+// Maps object ids to their index in an object pool. This is a flat hash table using open addressing
+// with linear probing, so that lookups and insertions take constant time on average. Removing an
+// id moves the following entries of its probe sequence back by one, so no tombstones are needed.
+struct ImIdMap
+{
+    struct Entry
+    {
+        int Id;
+        // An index of -1 marks an empty entry
+        int Index;
+    };
+
+    ImVector<Entry> Entries;
+    int             Count;
+
+    ImIdMap() : Entries(), Count(0) {}
+
+    static inline ImU32 Hash(const int id)
+    {
+        // The finalizer of MurmurHash3, which spreads sequential ids over the whole table
+        ImU32 h = static_cast<ImU32>(id);
+        h ^= h >> 16;
+        h *= 0x85ebca6bu;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Returns the entry containing the id, or the empty entry at which the id would be inserted.
+    inline int FindEntry(const int id) const
+    {
+        const int mask = Entries.Size - 1;
+        int       entry_idx = static_cast<int>(Hash(id) & static_cast<ImU32>(mask));
+        while (Entries[entry_idx].Index != -1 && Entries[entry_idx].Id != id)
+        {
+            entry_idx = (entry_idx + 1) & mask;
+        }
+        return entry_idx;
+    }
+
+    // Returns -1 if the id isn't in the map.
+    inline int GetIndex(const int id) const
+    {
+        return Entries.empty() ? -1 : Entries[FindEntry(id)].Index;
+    }
+
+    inline void SetIndex(const int id, const int index)
+    {
+        IM_ASSERT(index >= 0);
+
+        // Keep the table at most half full, so that probe sequences stay short
+        if (2 * (Count + 1) > Entries.Size)
+        {
+            Rehash(ImMax(16, 2 * Entries.Size));
+        }
+
+        Entry& entry = Entries[FindEntry(id)];
+        if (entry.Index == -1)
+        {
+            entry.Id = id;
+            ++Count;
+        }
+        entry.Index = index;
+    }
+
+    inline void Remove(const int id)
+    {
+        if (Entries.empty())
+        {
+            return;
+        }
+
+        const int mask = Entries.Size - 1;
+        int       hole_idx = FindEntry(id);
+        if (Entries[hole_idx].Index == -1)
+        {
+            return;
+        }
+
+        // Entries after the hole which can't be found without passing over it are moved into it
+        for (int entry_idx = (hole_idx + 1) & mask; Entries[entry_idx].Index != -1;
+             entry_idx = (entry_idx + 1) & mask)
+        {
+            const int home_idx =
+                static_cast<int>(Hash(Entries[entry_idx].Id) & static_cast<ImU32>(mask));
+            const int distance_to_hole = (hole_idx - home_idx) & mask;
+            const int distance_to_entry = (entry_idx - home_idx) & mask;
+            if (distance_to_hole < distance_to_entry)
+            {
+                Entries[hole_idx] = Entries[entry_idx];
+                hole_idx = entry_idx;
+            }
+        }
+
+        Entries[hole_idx].Index = -1;
+        --Count;
+    }
+
+    // Removes all ids, keeping the memory of the table.
+    inline void Clear()
+    {
+        for (int i = 0; i < Entries.Size; ++i)
+        {
+            Entries[i].Index = -1;
+        }
+        Count = 0;
+    }
+
+    // Makes room for the given number of ids, so that they can be inserted without rehashing.
+    inline void Reserve(const int count)
+    {
+        if (2 * count <= Entries.Size)
+        {
+            return;
+        }
+
+        int capacity = 16;
+        while (capacity < 2 * count)
+        {
+            capacity *= 2;
+        }
+        Rehash(capacity);
+    }
+
+    inline void Rehash(const int capacity)
+    {
+        IM_ASSERT((capacity & (capacity - 1)) == 0);
+
+        ImVector<Entry> old_entries;
+        old_entries.swap(Entries);
+
+        Entry empty_entry;
+        empty_entry.Id = 0;
+        empty_entry.Index = -1;
+        Entries.resize(capacity, empty_entry);
+
+        for (int i = 0; i < old_entries.Size; ++i)
+        {
+            if (old_entries[i].Index != -1)
+            {
+                Entries[FindEntry(old_entries[i].Id)] = old_entries[i];
+            }
+        }
+    }
+};
+
 // The object T must have the following interface:
 //
 // struct T
 // {
-//     T();
+//     typedef ... ColdData;
 //
-//     int id;
+//     T(int id);
+//
+//     int Id;
 // };
+//
+// The object's rarely accessed data is stored in a separate array of T::ColdData, indexed like
+// Pool, so that the loops over all objects don't need to stride over it.
 template<typename T>
 struct ImObjectPool
 {
-    ImVector<T>    Pool;
-    ImVector<bool> InUse;
-    ImVector<int>  FreeList;
-    ImGuiStorage   IdMap;
-
-    ImObjectPool() : Pool(), InUse(), FreeList(), IdMap() {}
+    ImVector<T>                    Pool;
+    ImVector<typename T::ColdData> Cold;
+    ImVector<bool>                 InUse;
+    ImVector<int>                  FreeList;
+    ImIdMap                        IdMap;
+    // The number of objects flagged in InUse. When every object in IdMap is in use, there is
+    // nothing for ObjectPoolUpdate() to destroy.
+    int NumInUse;
+
+    ImObjectPool() : Pool(), Cold(), InUse(), FreeList(), IdMap(), NumInUse(0) {}
+
+    ~ImObjectPool()
+    {
+        // The objects which are still mapped to their slot haven't been destroyed by
+        // ObjectPoolUpdate() yet, and may own memory of their own.
+        for (int i = 0; i < Pool.size(); ++i)
+        {
+            if (IdMap.GetIndex(Pool[i].Id) == i)
+            {
+                (Pool.Data + i)->~T();
+            }
+        }
+    }
 };
 
 // Emulates std::optional<int> using the sentinel value `INVALID_INDEX`.
@@ -128,13 +297,83 @@ private:
     int _Index;
 };
 
-struct ImNodeData
+// A table of the distinct styles used by an editor's objects. The objects store an index into the
+// table instead of a copy of the style. The styles are hashed and compared bytewise, so T must not
+// contain padding.
+template<typename T>
+struct ImStylePalette
 {
-    int    Id;
-    ImVec2 Origin; // The node origin is in editor space
-    ImRect TitleBarContentRect;
-    ImRect Rect;
+    // Styles[0] is a zero-initialized style, used by objects which haven't been submitted yet
+    ImVector<T> Styles;
+    // Maps the hash of a style to the index of the last style added with that hash. The styles
+    // sharing a hash are chained through NextIdx, which is indexed like Styles and ends with -1.
+    ImIdMap       Lookup;
+    ImVector<int> NextIdx;
+    // The index returned by the last call to Intern(). Consecutive objects usually share a style.
+    int LastIdx;
+    // The table size at which the styles no longer used by any object are dropped
+    int CollectSize;
+
+    enum
+    {
+        MinCollectSize = 256
+    };
+
+    ImStylePalette() : Styles(), Lookup(), NextIdx(), LastIdx(0), CollectSize(MinCollectSize)
+    {
+        T default_style;
+        memset((void*)&default_style, 0, sizeof(T));
+        Styles.push_back(default_style);
+        RebuildLookup();
+    }
+
+    static inline int Hash(const T& style)
+    {
+        return static_cast<int>(ImHashData((const void*)&style, sizeof(T)));
+    }
+
+    // Returns the index of the style, adding it to the table if it isn't there yet.
+    inline int Intern(const T& style)
+    {
+        if (memcmp((const void*)&Styles[LastIdx], (const void*)&style, sizeof(T)) == 0)
+        {
+            return LastIdx;
+        }
+
+        const int hash = Hash(style);
+        const int head_idx = Lookup.GetIndex(hash);
+        for (int style_idx = head_idx; style_idx != -1; style_idx = NextIdx[style_idx])
+        {
+            if (memcmp((const void*)&Styles[style_idx], (const void*)&style, sizeof(T)) == 0)
+            {
+                LastIdx = style_idx;
+                return style_idx;
+            }
+        }
+
+        Styles.push_back(style);
+        NextIdx.push_back(head_idx);
+        LastIdx = Styles.Size - 1;
+        Lookup.SetIndex(hash, LastIdx);
+        return LastIdx;
+    }
 
+    // Maps the hashes of the styles to their indices again, after the table has been rebuilt.
+    inline void RebuildLookup()
+    {
+        Lookup.Clear();
+        NextIdx.resize(Styles.Size);
+        for (int i = 0; i < Styles.Size; ++i)
+        {
+            const int hash = Hash(Styles[i]);
+            NextIdx[i] = Lookup.GetIndex(hash);
+            Lookup.SetIndex(hash, i);
+        }
+    }
+};
+
+struct ImNodeStyleData
+{
     struct
     {
         ImU32 Background, BackgroundHovered, BackgroundSelected, Outline, Titlebar, TitlebarHovered,
@@ -147,54 +386,496 @@ struct ImNodeData
         ImVec2 Padding;
         float  BorderThickness;
     } LayoutStyle;
+};
+
+struct ImPinStyleData
+{
+    struct
+    {
+        ImU32 Background, Hovered;
+    } ColorStyle;
+};
+
+struct ImLinkStyleData
+{
+    struct
+    {
+        ImU32 Base, Hovered, Selected;
+    } ColorStyle;
+};
+
+// The node's title bar and style, which are only accessed when the node is submitted or rendered
+struct ImNodeColdData
+{
+    ImRect TitleBarContentRect;
+    // Index into ImNodesEditorContext::NodeStyles
+    int    StyleIdx;
+
+    ImNodeColdData() : TitleBarContentRect(), StyleIdx(0) {}
+};
+
+struct ImNodeData
+{
+    typedef ImNodeColdData ColdData;
+
+    int    Id;
+    ImVec2 Origin; // The node origin is in editor space
+    ImRect Rect;
 
     ImVector<int> PinIndices;
     bool          Draggable;
+    // Mirrors whether the node's index is in ImNodesEditorContext::SelectedNodeIndices
+    bool          Selected;
+    // Whether the node was submitted, and could be hovered, during the last frame
+    bool          Submitted;
 
     ImNodeData(const int node_id)
-        : Id(node_id), Origin(0.0f, 0.0f), TitleBarContentRect(),
-          Rect(ImVec2(0.0f, 0.0f), ImVec2(0.0f, 0.0f)), ColorStyle(), LayoutStyle(), PinIndices(),
-          Draggable(true)
+        : Id(node_id), Origin(0.0f, 0.0f), Rect(ImVec2(0.0f, 0.0f), ImVec2(0.0f, 0.0f)),
+          PinIndices(), Draggable(true), Selected(false), Submitted(false)
     {
     }
 
     ~ImNodeData() { Id = INT_MIN; }
 };
 
+// The pin's attribute rectangle, flags and style, which are only accessed when the pin is
+// submitted, rendered or clicked
+struct ImPinColdData
+{
+    ImRect          AttributeRect;
+    ImNodesPinShape Shape;
+    int             Flags;
+    // Index into ImNodesEditorContext::PinStyles
+    int             StyleIdx;
+
+    ImPinColdData()
+        : AttributeRect(), Shape(ImNodesPinShape_CircleFilled), Flags(ImNodesAttributeFlags_None),
+          StyleIdx(0)
+    {
+    }
+};
+
 struct ImPinData
 {
+    typedef ImPinColdData ColdData;
+
     int                  Id;
     int                  ParentNodeIdx;
-    ImRect               AttributeRect;
     ImNodesAttributeType Type;
-    ImNodesPinShape      Shape;
     ImVec2               Pos; // screen-space coordinates
-    int                  Flags;
-
-    struct
-    {
-        ImU32 Background, Hovered;
-    } ColorStyle;
 
     ImPinData(const int pin_id)
-        : Id(pin_id), ParentNodeIdx(), AttributeRect(), Type(ImNodesAttributeType_None),
-          Shape(ImNodesPinShape_CircleFilled), Pos(), Flags(ImNodesAttributeFlags_None),
-          ColorStyle()
+        : Id(pin_id), ParentNodeIdx(), Type(ImNodesAttributeType_None), Pos()
     {
     }
 };
 
+struct ImLinkColdData
+{
+    // Index into ImNodesEditorContext::LinkStyles
+    int StyleIdx;
+
+    ImLinkColdData() : StyleIdx(0) {}
+};
+
 struct ImLinkData
 {
+    typedef ImLinkColdData ColdData;
+
     int Id;
     int StartPinIdx, EndPinIdx;
 
-    struct
+    // The link's curve flattened into a polyline, and the rectangle containing it, in grid space.
+    // The pin positions and segment density they were computed from are cached to detect when the
+    // geometry needs to be updated.
+    ImVector<ImVec2> GridSpacePolyline;
+    ImRect           GridSpaceBounds;
+    ImVec2           GridSpaceStartPos, GridSpaceEndPos;
+    float            LineSegmentsPerLength;
+
+    // Mirrors whether the link's index is in ImNodesEditorContext::SelectedLinkIndices
+    bool Selected;
+
+    // The pin indices are invalid until Link() sets them, so that a new link is always detected as
+    // a change to ImNodesEditorContext::PinLinks
+    ImLinkData(const int link_id)
+        : Id(link_id), StartPinIdx(-1), EndPinIdx(-1), GridSpacePolyline(), GridSpaceBounds(),
+          GridSpaceStartPos(FLT_MAX, FLT_MAX), GridSpaceEndPos(FLT_MAX, FLT_MAX),
+          LineSegmentsPerLength(0.f), Selected(false)
     {
-        ImU32 Base, Hovered, Selected;
-    } ColorStyle;
+    }
+};
+
+// A uniform grid over grid space, which maps each cell to the nodes overlapping it. It is used to
+// find the nodes and pins near the mouse cursor without iterating over every node. Each cell holds
+// a singly linked list of entries. Cells are looked up by a hash of their coordinates, so two cells
+// may share a list, and the nodes found in a cell still need to be tested against their geometry.
+struct ImSpatialGrid
+{
+    struct Entry
+    {
+        int NodeIdx;
+        int Next;
+    };
+
+    struct CellRange
+    {
+        int MinX, MinY, MaxX, MaxY;
+
+        CellRange() : MinX(0), MinY(0), MaxX(-1), MaxY(-1) {}
+
+        inline bool operator==(const CellRange& rhs) const
+        {
+            return MinX == rhs.MinX && MinY == rhs.MinY && MaxX == rhs.MaxX && MaxY == rhs.MaxY;
+        }
+    };
+
+    float CellSize;
+    // Maps a cell key to the index of the first entry in the cell. Only non-empty cells are stored.
+    ImIdMap         CellHeads;
+    ImVector<Entry> Entries;
+    int             FreeEntryHead;
+    // The cells each node has been inserted into, indexed by node index
+    ImVector<CellRange> NodeCellRanges;
+
+    ImSpatialGrid()
+        : CellSize(256.f), CellHeads(), Entries(), FreeEntryHead(-1), NodeCellRanges()
+    {
+    }
+};
+
+// A bounding volume hierarchy over the grid space bounds of the links, used for link hover
+// detection and box selection. The tree is stored in depth-first order: an internal node's first
+// child directly follows it, and each node stores the index of the first node after its subtree, so
+// the tree can be traversed without a stack. The tree is rebuilt when links are added or removed,
+// and refitted when links move.
+struct ImLinkBvh
+{
+    struct Node
+    {
+        ImRect Bounds;
+        int    SkipIdx;
+        // The range of LinkIndices contained in a leaf node. Internal nodes have a count of zero.
+        int LinkStart;
+        int LinkCount;
+    };
+
+    ImVector<Node> Nodes;
+    ImVector<int>  LinkIndices;
+
+    ImLinkBvh() : Nodes(), LinkIndices() {}
+};
+
+// The links connected to each pin, in compressed sparse row form: the indices of the links using
+// the pin at pin_idx are LinkIndices[Offsets[pin_idx]] up to, but not including,
+// LinkIndices[Offsets[pin_idx + 1]], in increasing order. Pins created after the index was built
+// have no entry. This part of the index is only rebuilt when it's needed after links have been
+// created, destroyed or reconnected, which is flagged by Dirty.
+//
+// The links are also hashed by their unordered pair of pins, so that a duplicate link can be found
+// in constant time. PairEntries is a flat hash table with linear probing. Each entry holds the
+// lowest index of the links connecting its pair of pins, and NextPairLinkIdx, indexed by link
+// index, chains the others in increasing order. The pairs are kept up to date as links are
+// created, destroyed or reconnected, with InsertLink() and RemoveLink().
+struct ImPinLinkIndex
+{
+    struct PairEntry
+    {
+        int MinPinIdx, MaxPinIdx;
+        // A link index of -1 marks an empty entry
+        int LinkIdx;
+    };
+
+    ImVector<int>       Offsets;
+    ImVector<int>       LinkIndices;
+    ImVector<PairEntry> PairEntries;
+    ImVector<int>       NextPairLinkIdx;
+    int                 NumPairs;
+    bool                Dirty;
+
+    ImPinLinkIndex()
+        : Offsets(), LinkIndices(), PairEntries(), NextPairLinkIdx(), NumPairs(0), Dirty(true)
+    {
+    }
+
+    static inline ImU32 HashPinPair(const int min_pin_idx, const int max_pin_idx)
+    {
+        return ImIdMap::Hash(
+            static_cast<int>(ImIdMap::Hash(min_pin_idx) ^ static_cast<ImU32>(max_pin_idx)));
+    }
+
+    // Returns the entry of the pair of pins, or the empty entry at which it would be inserted.
+    inline int FindPairEntry(const int min_pin_idx, const int max_pin_idx) const
+    {
+        const int mask = PairEntries.Size - 1;
+        int entry_idx = static_cast<int>(HashPinPair(min_pin_idx, max_pin_idx) & (ImU32)mask);
+        while (PairEntries[entry_idx].LinkIdx != -1 &&
+               (PairEntries[entry_idx].MinPinIdx != min_pin_idx ||
+                PairEntries[entry_idx].MaxPinIdx != max_pin_idx))
+        {
+            entry_idx = (entry_idx + 1) & mask;
+        }
+        return entry_idx;
+    }
+
+    // Returns the lowest index of the links connecting the two pins, in either direction, or -1 if
+    // there is no such link.
+    inline int FindFirstLinkBetween(int pin_idx0, int pin_idx1) const
+    {
+        if (PairEntries.empty())
+        {
+            return -1;
+        }
+
+        if (pin_idx0 > pin_idx1)
+        {
+            ImSwap(pin_idx0, pin_idx1);
+        }
+        return PairEntries[FindPairEntry(pin_idx0, pin_idx1)].LinkIdx;
+    }
 
-    ImLinkData(const int link_id) : Id(link_id), StartPinIdx(), EndPinIdx(), ColorStyle() {}
+    inline void InsertLink(const int link_idx, const int start_pin_idx, const int end_pin_idx)
+    {
+        // Keep the table at most half full, so that probe sequences stay short
+        if (2 * (NumPairs + 1) > PairEntries.Size)
+        {
+            RehashPairs(ImMax(16, 2 * PairEntries.Size));
+        }
+
+        if (link_idx >= NextPairLinkIdx.Size)
+        {
+            NextPairLinkIdx.resize(link_idx + 1, -1);
+        }
+
+        const int  min_pin_idx = ImMin(start_pin_idx, end_pin_idx);
+        const int  max_pin_idx = ImMax(start_pin_idx, end_pin_idx);
+        PairEntry& entry = PairEntries[FindPairEntry(min_pin_idx, max_pin_idx)];
+        if (entry.LinkIdx == -1)
+        {
+            entry.MinPinIdx = min_pin_idx;
+            entry.MaxPinIdx = max_pin_idx;
+            entry.LinkIdx = link_idx;
+            NextPairLinkIdx[link_idx] = -1;
+            ++NumPairs;
+        }
+        else if (link_idx < entry.LinkIdx)
+        {
+            NextPairLinkIdx[link_idx] = entry.LinkIdx;
+            entry.LinkIdx = link_idx;
+        }
+        else
+        {
+            int prev_link_idx = entry.LinkIdx;
+            while (NextPairLinkIdx[prev_link_idx] != -1 &&
+                   NextPairLinkIdx[prev_link_idx] < link_idx)
+            {
+                prev_link_idx = NextPairLinkIdx[prev_link_idx];
+            }
+            NextPairLinkIdx[link_idx] = NextPairLinkIdx[prev_link_idx];
+            NextPairLinkIdx[prev_link_idx] = link_idx;
+        }
+    }
+
+    // The pins must be the ones the link was inserted with.
+    inline void RemoveLink(const int link_idx, const int start_pin_idx, const int end_pin_idx)
+    {
+        const int  min_pin_idx = ImMin(start_pin_idx, end_pin_idx);
+        const int  max_pin_idx = ImMax(start_pin_idx, end_pin_idx);
+        const int  entry_idx = FindPairEntry(min_pin_idx, max_pin_idx);
+        PairEntry& entry = PairEntries[entry_idx];
+        IM_ASSERT(entry.LinkIdx != -1);
+
+        if (entry.LinkIdx != link_idx)
+        {
+            int prev_link_idx = entry.LinkIdx;
+            while (NextPairLinkIdx[prev_link_idx] != link_idx)
+            {
+                prev_link_idx = NextPairLinkIdx[prev_link_idx];
+                IM_ASSERT(prev_link_idx != -1);
+            }
+            NextPairLinkIdx[prev_link_idx] = NextPairLinkIdx[link_idx];
+            return;
+        }
+
+        if (NextPairLinkIdx[link_idx] != -1)
+        {
+            entry.LinkIdx = NextPairLinkIdx[link_idx];
+            return;
+        }
+
+        // The pair's last link was removed. Entries after the hole which can't be found without
+        // passing over it are moved into it, like in ImIdMap::Remove().
+        const int mask = PairEntries.Size - 1;
+        int       hole_idx = entry_idx;
+        for (int idx = (hole_idx + 1) & mask; PairEntries[idx].LinkIdx != -1;
+             idx = (idx + 1) & mask)
+        {
+            const int home_idx = static_cast<int>(
+                HashPinPair(PairEntries[idx].MinPinIdx, PairEntries[idx].MaxPinIdx) &
+                static_cast<ImU32>(mask));
+            const int distance_to_hole = (hole_idx - home_idx) & mask;
+            const int distance_to_entry = (idx - home_idx) & mask;
+            if (distance_to_hole < distance_to_entry)
+            {
+                PairEntries[hole_idx] = PairEntries[idx];
+                hole_idx = idx;
+            }
+        }
+
+        PairEntries[hole_idx].LinkIdx = -1;
+        --NumPairs;
+    }
+
+    inline void RehashPairs(const int capacity)
+    {
+        IM_ASSERT((capacity & (capacity - 1)) == 0);
+
+        PairEntry empty_entry;
+        empty_entry.MinPinIdx = empty_entry.MaxPinIdx = 0;
+        empty_entry.LinkIdx = -1;
+
+        ImVector<PairEntry> old_entries;
+        old_entries.swap(PairEntries);
+        PairEntries.resize(capacity, empty_entry);
+        for (int i = 0; i < old_entries.Size; ++i)
+        {
+            const PairEntry& old_entry = old_entries[i];
+            if (old_entry.LinkIdx != -1)
+            {
+                PairEntries[FindPairEntry(old_entry.MinPinIdx, old_entry.MaxPinIdx)] = old_entry;
+            }
+        }
+    }
+};
+
+// The order in which the nodes are drawn, from the bottom to the top. This is a doubly linked list
+// indexed by node index, so that a node can be moved to the top or removed in constant time. Each
+// node also stores a rank which increases from the bottom to the top of the list, so that the depth
+// of two nodes can be compared without walking the list.
+struct ImNodeDepthOrder
+{
+    // Indexed by node index. A node which isn't in the list has a rank of -1.
+    ImVector<int> Prev, Next, Rank;
+    int           Bottom, Top, Size;
+    int           NextRank;
+
+    ImNodeDepthOrder()
+        : Prev(), Next(), Rank(), Bottom(-1), Top(-1), Size(0), NextRank(0)
+    {
+    }
+
+    inline bool Contains(const int node_idx) const
+    {
+        return node_idx < Rank.Size && Rank[node_idx] != -1;
+    }
+
+    inline void Reserve(const int capacity)
+    {
+        Prev.reserve(capacity);
+        Next.reserve(capacity);
+        Rank.reserve(capacity);
+    }
+
+    inline void PushTop(const int node_idx)
+    {
+        IM_ASSERT(!Contains(node_idx));
+
+        if (node_idx >= Rank.Size)
+        {
+            Prev.resize(node_idx + 1, -1);
+            Next.resize(node_idx + 1, -1);
+            Rank.resize(node_idx + 1, -1);
+        }
+
+        if (NextRank == INT_MAX)
+        {
+            Renumber();
+        }
+
+        Prev[node_idx] = Top;
+        Next[node_idx] = -1;
+        Rank[node_idx] = NextRank++;
+        if (Top != -1)
+        {
+            Next[Top] = node_idx;
+        }
+        else
+        {
+            Bottom = node_idx;
+        }
+        Top = node_idx;
+        ++Size;
+    }
+
+    inline void Remove(const int node_idx)
+    {
+        IM_ASSERT(Contains(node_idx));
+
+        const int prev = Prev[node_idx];
+        const int next = Next[node_idx];
+        if (prev != -1)
+        {
+            Next[prev] = next;
+        }
+        else
+        {
+            Bottom = next;
+        }
+        if (next != -1)
+        {
+            Prev[next] = prev;
+        }
+        else
+        {
+            Top = prev;
+        }
+
+        Prev[node_idx] = -1;
+        Next[node_idx] = -1;
+        Rank[node_idx] = -1;
+        --Size;
+    }
+
+    inline void MoveToTop(const int node_idx)
+    {
+        if (node_idx != Top)
+        {
+            Remove(node_idx);
+            PushTop(node_idx);
+        }
+    }
+
+    // Assigns consecutive ranks from the bottom up, once the ranks handed out have run out.
+    inline void Renumber()
+    {
+        int rank = 0;
+        for (int node_idx = Bottom; node_idx != -1; node_idx = Next[node_idx])
+        {
+            Rank[node_idx] = rank++;
+        }
+        NextRank = rank;
+    }
+};
+
+// The hovered objects resolved during the last frame, and the state they were resolved from. The
+// hovered objects only need to be resolved again once the state has changed.
+struct ImHoverCache
+{
+    bool   Valid;
+    ImU32  SceneGeneration;
+    ImVec2 MousePos;
+    ImVec2 Panning;
+    float  PinHoverRadius, LinkHoverDistance;
+    int    NumNodesInUse, NumPinsInUse, NumLinksInUse;
+
+    ImOptionalIndex HoveredNodeIdx, HoveredPinIdx, HoveredLinkIdx;
+
+    ImHoverCache()
+        : Valid(false), SceneGeneration(0), MousePos(), Panning(), PinHoverRadius(0.f),
+          LinkHoverDistance(0.f), NumNodesInUse(0), NumPinsInUse(0), NumLinksInUse(0),
+          HoveredNodeIdx(), HoveredPinIdx(), HoveredLinkIdx()
+    {
+    }
 };
 
 struct ImClickInteractionState
@@ -249,7 +930,28 @@ struct ImNodesEditorContext
     ImObjectPool<ImPinData>  Pins;
     ImObjectPool<ImLinkData> Links;
 
-    ImVector<int> NodeDepthOrder;
+    ImNodeDepthOrder NodeDepthOrder;
+
+    // The styles the objects were last submitted with
+    ImStylePalette<ImNodeStyleData> NodeStyles;
+    ImStylePalette<ImPinStyleData>  PinStyles;
+    ImStylePalette<ImLinkStyleData> LinkStyles;
+
+    // Spatial indices of the nodes and links, used for hover detection and box selection
+    ImSpatialGrid SpatialGrid;
+    ImLinkBvh     LinkBvh;
+
+    // The links connected to each pin, used for link hover detection and duplicate link checks
+    ImPinLinkIndex PinLinks;
+
+    // Incremented whenever the geometry, the depth order or the hoverability of the objects
+    // changes. Together with the mouse position, it decides whether the cached hovered objects can
+    // be reused.
+    ImU32        SceneGeneration;
+    ImHoverCache HoverCache;
+
+    // Objects which aren't submitted during a frame are only destroyed when not in retained mode
+    bool RetainedMode;
 
     // ui related fields
     ImVec2 Panning;
@@ -268,6 +970,11 @@ struct ImNodesEditorContext
 
     ImClickInteractionState ClickInteraction;
 
+    // Whether the next frame would be rendered differently with the same input, and the hovered
+    // objects of the last frame it is partly decided from
+    bool            NeedsRedraw;
+    ImOptionalIndex LastHoveredNodeIdx, LastHoveredPinIdx, LastHoveredLinkIdx;
+
     // Mini-map state set by MiniMap()
 
     bool                                       MiniMapEnabled;
@@ -282,26 +989,52 @@ struct ImNodesEditorContext
     ImRect MiniMapContentScreenSpace;
     float  MiniMapScaling;
 
+    // Statistics collected during the last EndNodeEditor() call
+    ImNodesFrameStats FrameStats;
+
     ImNodesEditorContext()
-        : Nodes(), Pins(), Links(), Panning(0.f, 0.f), SelectedNodeIndices(), SelectedLinkIndices(),
-          SelectedNodeOffsets(), PrimaryNodeOffset(0.f, 0.f), ClickInteraction(),
-          MiniMapEnabled(false), MiniMapSizeFraction(0.0f), MiniMapNodeHoveringCallback(NULL),
-          MiniMapNodeHoveringCallbackUserData(NULL), MiniMapScaling(0.0f)
+        : Nodes(), Pins(), Links(), NodeStyles(), PinStyles(), LinkStyles(), SpatialGrid(),
+          LinkBvh(), PinLinks(), SceneGeneration(0), HoverCache(), RetainedMode(false),
+          Panning(0.f, 0.f), SelectedNodeIndices(), SelectedLinkIndices(), SelectedNodeOffsets(),
+          PrimaryNodeOffset(0.f, 0.f), ClickInteraction(), NeedsRedraw(false),
+          LastHoveredNodeIdx(), LastHoveredPinIdx(), LastHoveredLinkIdx(), MiniMapEnabled(false),
+          MiniMapSizeFraction(0.0f), MiniMapNodeHoveringCallback(NULL),
+          MiniMapNodeHoveringCallbackUserData(NULL), MiniMapScaling(0.0f), FrameStats()
     {
     }
 };
 
+// A range of the shared node draw channel's index buffer, used with
+// ImNodesStyleFlags_SingleNodeDrawChannel.
+struct ImNodeDrawRange
+{
+    int IdxBegin, IdxEnd;
+
+    ImNodeDrawRange() : IdxBegin(0), IdxEnd(0) {}
+};
+
 struct ImNodesContext
 {
     ImNodesEditorContext* DefaultEditorCtx;
     ImNodesEditorContext* EditorCtx;
 
     // Canvas draw list and helper state
-    ImDrawList*   CanvasDrawList;
-    ImGuiStorage  NodeIdxToSubmissionIdx;
-    ImVector<int> NodeIdxSubmissionOrder;
-    ImVector<int> NodeIndicesOverlappingWithMouse;
-    ImVector<int> OccludedPinIndices;
+    ImDrawList*      CanvasDrawList;
+    // Indexed by node index. Nodes which haven't been submitted during the frame map to -1.
+    ImVector<int>    NodeIdxToSubmissionIdx;
+    ImVector<int>    NodeIdxSubmissionOrder;
+    ImVector<int>    SubmissionIdxDepthOrder;
+    ImVector<int>    NodeIndicesOverlappingWithMouse;
+    ImVector<int>    LinkIndicesOverlappingWithRect;
+    ImVector<ImVec2> LinkPolylineScreenSpace;
+
+    // Node draw ranges, when all nodes are rendered into a single draw channel. Each node has a
+    // background and a foreground range, indexed in the same order as the node draw channels are.
+    bool                      SingleNodeDrawChannel;
+    ImVector<ImNodeDrawRange> NodeDrawRanges;
+    int                       CurrentNodeDrawRangeIdx;
+    ImVector<ImDrawCmd>       SortedNodeDrawCmds;
+    ImVector<ImDrawIdx>       SortedNodeDrawIndices;
 
     // Canvas extents
     ImVec2 CanvasOriginScreenSpace;
@@ -351,6 +1084,24 @@ struct ImNodesContext
     bool  AltMouseDragging;
     float AltMouseScrollDelta;
     bool  MultipleSelectModifier;
+
+    // The statistics of the frame in progress, which are copied to the editor in EndNodeEditor().
+    // The canvas draw list buffer sizes at the start of the frame are used to count the vertices
+    // and indices emitted during the frame.
+    ImNodesFrameStats FrameStats;
+    int               CanvasVtxBufferStart;
+    int               CanvasIdxBufferStart;
+
+    // The canvas overlays toggled in ShowMetricsWindow()
+    bool MetricsShowNodeRects;
+    bool MetricsShowLinkRects;
+    bool MetricsShowSpatialGridCells;
+
+    // Allocation counter state. Only the allocations made while AllocationScopeDepth is positive
+    // are counted, i.e. inside of the imnodes functions, but not inside of the UI code of the nodes.
+    bool AllocationCounterEnabled;
+    int  AllocationScopeDepth;
+    int  FrameAllocationCount;
 };
 
 namespace IMNODES_NAMESPACE
@@ -367,54 +1118,126 @@ static inline ImNodesEditorContext& EditorContextGet()
 template<typename T>
 static inline int ObjectPoolFind(const ImObjectPool<T>& objects, const int id)
 {
-    const int index = objects.IdMap.GetInt(static_cast<ImGuiID>(id), -1);
+    const int index = objects.IdMap.GetIndex(id);
     return index;
 }
 
+// Makes room for the given number of objects, so that the pool doesn't need to grow while they are
+// created.
 template<typename T>
-static inline void ObjectPoolUpdate(ImObjectPool<T>& objects)
+static inline void ObjectPoolReserve(ImObjectPool<T>& objects, const int capacity)
 {
-    for (int i = 0; i < objects.InUse.size(); ++i)
+    objects.Pool.reserve(capacity);
+    objects.Cold.reserve(capacity);
+    objects.InUse.reserve(capacity);
+    objects.IdMap.Reserve(capacity);
+}
+
+// The InUse flags should only be modified through this function, to keep NumInUse up to date.
+template<typename T>
+static inline void ObjectPoolSetInUse(ImObjectPool<T>& objects, const int index, const bool in_use)
+{
+    if (objects.InUse[index] != in_use)
     {
-        const int id = objects.Pool[i].Id;
+        objects.InUse[index] = in_use;
+        objects.NumInUse += in_use ? 1 : -1;
+    }
+}
+
+// Destroys the object and frees its slot. The index must belong to a live object.
+template<typename T>
+static inline void ObjectPoolDestroy(ImObjectPool<T>& objects, const int index)
+{
+    ObjectPoolSetInUse(objects, index, false);
+    objects.IdMap.Remove(objects.Pool[index].Id);
+    objects.FreeList.push_back(index);
+    (objects.Pool.Data + index)->~T();
+}
+
+// Destroys the objects which are no longer in use. Returns true if any objects were destroyed.
+template<typename T>
+static inline bool ObjectPoolUpdate(ImObjectPool<T>& objects)
+{
+    if (objects.NumInUse == objects.IdMap.Count)
+    {
+        return false;
+    }
 
-        if (!objects.InUse[i] && objects.IdMap.GetInt(id, -1) == i)
+    for (int i = 0; i < objects.InUse.size(); ++i)
+    {
+        if (!objects.InUse[i] && objects.IdMap.GetIndex(objects.Pool[i].Id) == i)
         {
-            objects.IdMap.SetInt(id, -1);
-            objects.FreeList.push_back(i);
-            (objects.Pool.Data + i)->~T();
+            ObjectPoolDestroy(objects, i);
         }
     }
+
+    return true;
 }
 
+// Node pools are updated with NodePoolUpdate(), which also maintains the editor's depth order
 template<>
-inline void ObjectPoolUpdate(ImObjectPool<ImNodeData>& nodes)
+bool ObjectPoolUpdate(ImObjectPool<ImNodeData>& nodes) = delete;
+
+// Destroys the nodes of the editor which are no longer in use. Returns true if any nodes were
+// destroyed.
+inline bool NodePoolUpdate(ImNodesEditorContext& editor)
 {
+    ImObjectPool<ImNodeData>& nodes = editor.Nodes;
+    if (nodes.NumInUse == nodes.IdMap.Count)
+    {
+        return false;
+    }
+
     for (int i = 0; i < nodes.InUse.size(); ++i)
     {
-        if (nodes.InUse[i])
+        if (!nodes.InUse[i] && nodes.IdMap.GetIndex(nodes.Pool[i].Id) == i)
         {
-            nodes.Pool[i].PinIndices.clear();
+            // Remove node idx from the depth order before the idx slot is freed
+            editor.NodeDepthOrder.Remove(i);
+            ObjectPoolDestroy(nodes, i);
         }
-        else
-        {
-            const int id = nodes.Pool[i].Id;
+    }
 
-            if (nodes.IdMap.GetInt(id, -1) == i)
-            {
-                // Remove node idx form depth stack the first time we detect that this idx slot is
-                // unused
-                ImVector<int>&   depth_stack = EditorContextGet().NodeDepthOrder;
-                const int* const elem = depth_stack.find(i);
-                IM_ASSERT(elem != depth_stack.end());
-                depth_stack.erase(elem);
-
-                nodes.IdMap.SetInt(id, -1);
-                nodes.FreeList.push_back(i);
-                (nodes.Pool.Data + i)->~ImNodeData();
-            }
+    return true;
+}
+
+// Link pools are updated with LinkPoolUpdate(), which also maintains the editor's pin link index
+template<>
+bool ObjectPoolUpdate(ImObjectPool<ImLinkData>& links) = delete;
+
+// Destroys the link and removes it from the editor's pin link index. The index must belong to a live
+// link.
+inline void LinkPoolDestroy(ImNodesEditorContext& editor, const int link_idx)
+{
+    const ImLinkData& link = editor.Links.Pool[link_idx];
+    // Links get their pins in Link(), right after they are created
+    if (link.StartPinIdx != -1)
+    {
+        editor.PinLinks.RemoveLink(link_idx, link.StartPinIdx, link.EndPinIdx);
+    }
+    editor.PinLinks.Dirty = true;
+    ObjectPoolDestroy(editor.Links, link_idx);
+}
+
+// Destroys the links of the editor which are no longer in use. Returns true if any links were
+// destroyed.
+inline bool LinkPoolUpdate(ImNodesEditorContext& editor)
+{
+    ImObjectPool<ImLinkData>& links = editor.Links;
+    if (links.NumInUse == links.IdMap.Count)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < links.InUse.size(); ++i)
+    {
+        if (!links.InUse[i] && links.IdMap.GetIndex(links.Pool[i].Id) == i)
+        {
+            LinkPoolDestroy(editor, i);
         }
     }
+
+    return true;
 }
 
 template<typename T>
@@ -424,12 +1247,13 @@ static inline void ObjectPoolReset(ImObjectPool<T>& objects)
     {
         memset(objects.InUse.Data, 0, objects.InUse.size_in_bytes());
     }
+    objects.NumInUse = 0;
 }
 
 template<typename T>
 static inline int ObjectPoolFindOrCreateIndex(ImObjectPool<T>& objects, const int id)
 {
-    int index = objects.IdMap.GetInt(static_cast<ImGuiID>(id), -1);
+    int index = objects.IdMap.GetIndex(id);
 
     // Construct new object
     if (index == -1)
@@ -440,7 +1264,8 @@ static inline int ObjectPoolFindOrCreateIndex(ImObjectPool<T>& objects, const in
             IM_ASSERT(objects.Pool.size() == objects.InUse.size());
             const int new_size = objects.Pool.size() + 1;
             objects.Pool.resize(new_size);
-            objects.InUse.resize(new_size);
+            objects.Cold.resize(new_size);
+            objects.InUse.resize(new_size, false);
         }
         else
         {
@@ -448,19 +1273,24 @@ static inline int ObjectPoolFindOrCreateIndex(ImObjectPool<T>& objects, const in
             objects.FreeList.pop_back();
         }
         IM_PLACEMENT_NEW(objects.Pool.Data + index) T(id);
-        objects.IdMap.SetInt(static_cast<ImGuiID>(id), index);
+        IM_PLACEMENT_NEW(objects.Cold.Data + index) typename T::ColdData();
+        objects.IdMap.SetIndex(id, index);
     }
 
     // Flag it as used
-    objects.InUse[index] = true;
+    ObjectPoolSetInUse(objects, index, true);
 
     return index;
 }
 
+// Nodes are created with NodePoolFindOrCreateIndex(), which also maintains the editor's depth order
 template<>
-inline int ObjectPoolFindOrCreateIndex(ImObjectPool<ImNodeData>& nodes, const int node_id)
+int ObjectPoolFindOrCreateIndex(ImObjectPool<ImNodeData>& nodes, const int node_id) = delete;
+
+inline int NodePoolFindOrCreateIndex(ImNodesEditorContext& editor, const int node_id)
 {
-    int node_idx = nodes.IdMap.GetInt(static_cast<ImGuiID>(node_id), -1);
+    ImObjectPool<ImNodeData>& nodes = editor.Nodes;
+    int                       node_idx = nodes.IdMap.GetIndex(node_id);
 
     // Construct new node
     if (node_idx == -1)
@@ -471,7 +1301,8 @@ inline int ObjectPoolFindOrCreateIndex(ImObjectPool<ImNodeData>& nodes, const in
             IM_ASSERT(nodes.Pool.size() == nodes.InUse.size());
             const int new_size = nodes.Pool.size() + 1;
             nodes.Pool.resize(new_size);
-            nodes.InUse.resize(new_size);
+            nodes.Cold.resize(new_size);
+            nodes.InUse.resize(new_size, false);
         }
         else
         {
@@ -479,14 +1310,14 @@ inline int ObjectPoolFindOrCreateIndex(ImObjectPool<ImNodeData>& nodes, const in
             nodes.FreeList.pop_back();
         }
         IM_PLACEMENT_NEW(nodes.Pool.Data + node_idx) ImNodeData(node_id);
-        nodes.IdMap.SetInt(static_cast<ImGuiID>(node_id), node_idx);
+        IM_PLACEMENT_NEW(nodes.Cold.Data + node_idx) ImNodeColdData();
+        nodes.IdMap.SetIndex(node_id, node_idx);
 
-        ImNodesEditorContext& editor = EditorContextGet();
-        editor.NodeDepthOrder.push_back(node_idx);
+        editor.NodeDepthOrder.PushTop(node_idx);
     }
 
     // Flag node as used
-    nodes.InUse[node_idx] = true;
+    ObjectPoolSetInUse(nodes, node_idx, true);
 
     return node_idx;
 }
@@ -497,4 +1328,93 @@ static inline T& ObjectPoolFindOrCreateObject(ImObjectPool<T>& objects, const in
     const int index = ObjectPoolFindOrCreateIndex(objects, id);
     return objects.Pool[index];
 }
+
+inline ImNodeData& NodePoolFindOrCreateObject(ImNodesEditorContext& editor, const int node_id)
+{
+    const int node_idx = NodePoolFindOrCreateIndex(editor, node_id);
+    return editor.Nodes.Pool[node_idx];
+}
+
+// Moves the live objects to the front of the pool, keeping their order, and releases the memory of
+// the free slots. new_indices maps each old index to the object's new index, or to -1 for free
+// slots. Any other indices into the pool need to be remapped by the caller.
+template<typename T>
+static inline void ObjectPoolCompact(ImObjectPool<T>& objects, ImVector<int>& new_indices)
+{
+    const int num_objects = objects.IdMap.Count;
+
+    ImVector<T>                    pool;
+    ImVector<typename T::ColdData> cold;
+    ImVector<bool>                 in_use;
+    ImIdMap                        id_map;
+    pool.reserve(num_objects);
+    cold.reserve(num_objects);
+    in_use.reserve(num_objects);
+    id_map.Reserve(num_objects);
+
+    new_indices.resize(objects.Pool.size());
+    for (int i = 0; i < objects.Pool.size(); ++i)
+    {
+        const int id = objects.Pool[i].Id;
+        if (objects.IdMap.GetIndex(id) != i)
+        {
+            new_indices[i] = -1;
+            continue;
+        }
+
+        // The objects are relocated with memcpy, like when the pool grows
+        new_indices[i] = pool.Size;
+        id_map.SetIndex(id, pool.Size);
+        memcpy((void*)(pool.Data + pool.Size), (const void*)(objects.Pool.Data + i), sizeof(T));
+        ++pool.Size;
+        cold.push_back(objects.Cold[i]);
+        in_use.push_back(objects.InUse[i]);
+    }
+
+    objects.Pool.swap(pool);
+    objects.Cold.swap(cold);
+    objects.InUse.swap(in_use);
+    objects.IdMap.Entries.swap(id_map.Entries);
+    objects.FreeList.clear();
+}
+
+// Drops the styles which are no longer used by any of the live objects, once the palette has
+// grown to its collection size. The style indices of the objects are remapped.
+template<typename T, typename S>
+static inline void ObjectPoolCollectStyles(ImObjectPool<T>& objects, ImStylePalette<S>& palette)
+{
+    if (palette.Styles.Size < palette.CollectSize)
+    {
+        return;
+    }
+
+    ImVector<int> new_indices;
+    new_indices.resize(palette.Styles.Size, -1);
+    ImVector<S> styles;
+    // The default style stays first
+    new_indices[0] = 0;
+    styles.push_back(palette.Styles[0]);
+
+    for (int i = 0; i < objects.Pool.size(); ++i)
+    {
+        if (objects.IdMap.GetIndex(objects.Pool[i].Id) != i)
+        {
+            continue;
+        }
+
+        int& style_idx = objects.Cold[i].StyleIdx;
+        if (new_indices[style_idx] == -1)
+        {
+            new_indices[style_idx] = styles.Size;
+            styles.push_back(palette.Styles[style_idx]);
+        }
+        style_idx = new_indices[style_idx];
+    }
+
+    palette.Styles.swap(styles);
+    palette.RebuildLookup();
+    palette.LastIdx = 0;
+    // Objects using many distinct styles shouldn't trigger a collection every frame
+    palette.CollectSize = ImMax((int)ImStylePalette<S>::MinCollectSize, 2 * palette.Styles.Size);
+}
 } // namespace IMNODES_NAMESPACE